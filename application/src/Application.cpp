@@ -3,6 +3,7 @@
 #include "Application.h"
 #include "ApplicationContext.h"
 #include "CameraSystem.h"
+#include "CollisionCache.h"
 #include "GeodataContext.h"
 #include "GeodataSystem.h"
 #include "LoadingSystem.h"
@@ -10,6 +11,7 @@
 #include "RenderingSystem.h"
 #include "UIContext.h"
 #include "UISystem.h"
+#include "UnrealLoader.h"
 #include "WindowContext.h"
 #include "WindowSystem.h"
 
@@ -29,6 +31,7 @@ void Application::preview(const std::filesystem::path &client_root,
     GeodataContext geodata_context{};
 
     Renderer renderer{rendering_context};
+    const UnrealLoader unreal_loader{client_root, unreal::LoadProfile::Full};
 
     // Initialize systems
     std::vector<std::unique_ptr<System>> systems;
@@ -42,9 +45,10 @@ void Application::preview(const std::filesystem::path &client_root,
     systems.push_back(
         std::make_unique<CameraSystem>(rendering_context, window_context));
     systems.push_back(std::make_unique<LoadingSystem>(
-        geodata_context, &renderer, client_root, maps));
-    systems.push_back(std::make_unique<GeodataSystem>(geodata_context,
-                                                      ui_context, &renderer));
+        geodata_context, &renderer, unreal_loader, nullptr, maps));
+    systems.push_back(std::make_unique<GeodataSystem>(
+        geodata_context, ui_context, &renderer,
+        std::max(std::thread::hardware_concurrency(), 1u)));
 
     // Run application
     application_context.running = true;
@@ -77,20 +81,60 @@ void Application::preview(const std::filesystem::path &client_root,
 }
 
 void Application::build(const std::filesystem::path &client_root,
-                        const std::vector<std::string> &maps) const {
+                        const std::vector<std::string> &maps,
+                        std::size_t jobs, bool use_cache) const {
+
+  // Packages and converted meshes are shared by all maps, only collision
+  // geometry is needed to build geodata
+  const UnrealLoader unreal_loader{client_root,
+                                   unreal::LoadProfile::Collision};
+  const CollisionCache collision_cache{"cache", unreal_loader};
+  const auto *cache = use_cache ? &collision_cache : nullptr;
+
+  // Every worker keeps its own contexts and geodata builder (with export
+  // buffer) and reuses them for all maps it takes from the pool
+  struct Worker {
+    UIContext ui_context;
+    GeodataContext geodata_context;
+    GeodataSystem geodata_system;
+
+    explicit Worker(std::size_t thread_count)
+        : geodata_system{geodata_context, ui_context, nullptr, thread_count} {
+    }
+  };
 
-  for (const auto &map : maps) {
-    UIContext ui_context{};
-    GeodataContext geodata_context{};
+  utils::JobPool job_pool{
+      std::max<std::size_t>(std::min(jobs, maps.size()), 1)};
+  std::vector<std::unique_ptr<Worker>> workers;
 
-    LoadingSystem loading_system{geodata_context, nullptr, client_root, {map}};
-    GeodataSystem geodata_system{geodata_context, ui_context, nullptr};
+  // Cores are split between workers for collision detection
+  const auto worker_thread_count = std::max<std::size_t>(
+      std::thread::hardware_concurrency() / job_pool.thread_count(), 1);
 
-    ui_context.geodata.set_defaults();
+  for (std::size_t i = 0; i < job_pool.thread_count(); ++i) {
+    auto &worker = workers.emplace_back(
+        std::make_unique<Worker>(worker_thread_count));
+    worker->ui_context.geodata.set_defaults();
+    worker->ui_context.geodata.should_export = true;
+  }
 
-    ui_context.geodata.should_export = true;
-    ui_context.geodata.build_handler();
+  for (const auto &map : maps) {
+    job_pool.submit([&workers, &unreal_loader, cache,
+                     &map](std::size_t worker_index) {
+      auto &worker = *workers[worker_index];
+      worker.geodata_context.maps.clear();
+
+      {
+        LoadingSystem loading_system{worker.geodata_context, nullptr,
+                                     unreal_loader, cache, {map}};
+        unreal_loader.unload_map_packages(map);
+      }
+
+      worker.ui_context.geodata.build_handler();
+    });
   }
 
+  job_pool.wait();
+
   std::cout << "Done!" << std::endl;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -11,5 +12,6 @@ public:
   void preview(const std::filesystem::path &client_root,
                const std::vector<std::string> &maps) const;
   void build(const std::filesystem::path &client_root,
-             const std::vector<std::string> &maps) const;
+             const std::vector<std::string> &maps, std::size_t jobs,
+             bool use_cache) const;
 };
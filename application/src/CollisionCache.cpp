@@ -0,0 +1,283 @@
+#include "pch.h"
+
+#include "CollisionCache.h"
+
+#include <utils/MappedFile.h>
+
+#include <array>
+#include <cstring>
+
+// Bump when conversion of Unreal objects to collision geometry changes
+static constexpr std::uint32_t CACHE_VERSION = 1;
+
+static constexpr std::array<char, 8> CACHE_MAGIC = {'L', '2', 'M', 'C',
+                                                    'O', 'L', 'L', '\0'};
+
+// Build options changing collision geometry
+static constexpr std::uint32_t CACHE_FLAG_TERRAIN = 1 << 0;
+static constexpr std::uint32_t CACHE_FLAG_MORTON_ORDER = 1 << 1;
+
+static constexpr std::uint32_t CACHE_FLAGS = 0
+#ifdef LOAD_TERRAIN
+                                             | CACHE_FLAG_TERRAIN
+#endif
+#ifdef MORTON_ORDER
+                                             | CACHE_FLAG_MORTON_ORDER
+#endif
+    ;
+
+// Entry layout (native byte order, cache isn't meant to be portable):
+// header, package records, package names (padded to 8 bytes), vertices,
+// indices. Arrays are stored as is, so they can be used right from the
+// mapping.
+struct EntryHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint32_t package_count;
+  std::uint32_t names_size;
+  std::uint64_t vertex_count;
+  std::uint64_t index_count;
+  std::array<float, 6> bounding_box;
+};
+
+struct PackageRecord {
+  std::uint64_t hash;
+  std::uint32_t name_offset;
+  std::uint32_t name_size;
+};
+
+static_assert(sizeof(EntryHeader) == 64);
+static_assert(sizeof(PackageRecord) == 16);
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+
+static auto align(std::size_t size) -> std::size_t { return (size + 7) & ~7; }
+
+static auto hash_bytes(const unsigned char *data, std::size_t size)
+    -> std::uint64_t {
+
+  static constexpr std::uint64_t prime = 0x100000001b3;
+  std::uint64_t hash = 0xcbf29ce484222325 ^ size;
+  std::size_t i = 0;
+
+  // FNV-1a over 8 byte words, with extra mixing of high bits
+  for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * prime;
+    hash ^= hash >> 29;
+  }
+
+  for (; i < size; ++i) {
+    hash = (hash ^ data[i]) * prime;
+  }
+
+  return hash;
+}
+
+CollisionCache::CollisionCache(const std::filesystem::path &path,
+                               const UnrealLoader &unreal_loader)
+    : m_path{path}, m_unreal_loader{unreal_loader} {}
+
+auto CollisionCache::load(const std::string &map_name) const
+    -> std::optional<geodata::Map> {
+
+  const utils::MappedFile file{entry_path(map_name)};
+
+  if (!file.valid() || file.size() < sizeof(EntryHeader)) {
+    return {};
+  }
+
+  EntryHeader header{};
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+      header.flags != CACHE_FLAGS) {
+    return {};
+  }
+
+  // Counts come from the file, every section must fit into the rest of it
+  auto offset = sizeof(EntryHeader);
+  auto broken = false;
+
+  const auto section = [&file, &offset, &broken](std::uint64_t count,
+                                                  std::size_t element_size) {
+    const auto section_offset = offset;
+
+    if (count > (file.size() - offset) / element_size) {
+      broken = true;
+    } else {
+      offset += count * element_size;
+    }
+
+    return section_offset;
+  };
+
+  const auto records_offset =
+      section(header.package_count, sizeof(PackageRecord));
+  const auto names_offset = section(align(header.names_size), 1);
+  const auto vertices_offset = section(header.vertex_count, sizeof(glm::vec3));
+  const auto indices_offset =
+      section(header.index_count, sizeof(unsigned int));
+
+  if (broken || offset != file.size() || header.index_count % 3 != 0) {
+    utils::Log(utils::LOG_WARN, "App")
+        << "Broken collision cache entry: " << map_name << std::endl;
+    return {};
+  }
+
+  // Any changed package invalidates the entry
+  for (std::uint32_t i = 0; i < header.package_count; ++i) {
+    PackageRecord record{};
+    std::memcpy(&record, file.data() + records_offset + i * sizeof(record),
+                sizeof(record));
+
+    if (std::uint64_t{record.name_offset} + record.name_size >
+        header.names_size) {
+
+      utils::Log(utils::LOG_WARN, "App")
+          << "Broken collision cache entry: " << map_name << std::endl;
+      return {};
+    }
+
+    const std::string package_name{
+        reinterpret_cast<const char *>(file.data() + names_offset +
+                                       record.name_offset),
+        record.name_size};
+
+    if (package_hash(package_name) != record.hash) {
+      utils::Log(utils::LOG_INFO, "App")
+          << "Collision cache entry is outdated: " << map_name
+          << " (package: " << package_name << ")" << std::endl;
+      return {};
+    }
+  }
+
+  std::vector<glm::vec3> vertices(header.vertex_count);
+  std::memcpy(vertices.data(), file.data() + vertices_offset,
+              vertices.size() * sizeof(glm::vec3));
+
+  std::vector<unsigned int> indices(header.index_count);
+  std::memcpy(indices.data(), file.data() + indices_offset,
+              indices.size() * sizeof(unsigned int));
+
+  if (std::any_of(indices.begin(), indices.end(), [&vertices](auto index) {
+        return index >= vertices.size();
+      })) {
+
+    utils::Log(utils::LOG_WARN, "App")
+        << "Broken collision cache entry: " << map_name << std::endl;
+    return {};
+  }
+
+  const auto &box = header.bounding_box;
+
+  return geodata::Map{map_name,
+                      geometry::Box{{box[0], box[1], box[2]},
+                                    {box[3], box[4], box[5]}},
+                      std::move(vertices), std::move(indices)};
+}
+
+void CollisionCache::store(const geodata::Map &map,
+                           const std::vector<std::string> &packages) const {
+
+  std::vector<PackageRecord> records;
+  std::string names;
+
+  for (const auto &package : packages) {
+    records.push_back({package_hash(package),
+                       static_cast<std::uint32_t>(names.size()),
+                       static_cast<std::uint32_t>(package.size())});
+    names += package;
+  }
+
+  const auto &box = map.bounding_box();
+
+  EntryHeader header{};
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.flags = CACHE_FLAGS;
+  header.package_count = static_cast<std::uint32_t>(records.size());
+  header.names_size = static_cast<std::uint32_t>(names.size());
+  header.vertex_count = map.vertices().size();
+  header.index_count = map.indices().size();
+  header.bounding_box = {box.min().x, box.min().y, box.min().z,
+                         box.max().x, box.max().y, box.max().z};
+
+  names.resize(align(names.size()), '\0');
+
+  // Directory is created only when the cache is used, write errors are
+  // reported below
+  std::error_code error;
+  std::filesystem::create_directories(m_path, error);
+
+  // Written next to the entry and renamed, so readers never see a partial
+  // entry
+  const auto path = entry_path(map.name());
+  auto temporary_path = path;
+  temporary_path += ".tmp";
+
+  {
+    std::ofstream output{temporary_path, std::ios::binary};
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char *>(records.data()),
+                 records.size() * sizeof(PackageRecord));
+    output.write(names.data(), names.size());
+    output.write(reinterpret_cast<const char *>(map.vertices().data()),
+                 map.vertices().size() * sizeof(glm::vec3));
+    output.write(reinterpret_cast<const char *>(map.indices().data()),
+                 map.indices().size() * sizeof(unsigned int));
+
+    if (!output) {
+      utils::Log(utils::LOG_WARN, "App")
+          << "Can't write collision cache entry: " << temporary_path
+          << std::endl;
+      output.close();
+      std::filesystem::remove(temporary_path, error);
+      return;
+    }
+  }
+
+  std::filesystem::rename(temporary_path, path, error);
+
+  if (error) {
+    utils::Log(utils::LOG_WARN, "App")
+        << "Can't store collision cache entry: " << path << " ("
+        << error.message() << ")" << std::endl;
+    std::filesystem::remove(temporary_path, error);
+  }
+}
+
+auto CollisionCache::entry_path(const std::string &map_name) const
+    -> std::filesystem::path {
+
+  return m_path / (map_name + ".collision");
+}
+
+auto CollisionCache::package_hash(const std::string &package_name) const
+    -> std::uint64_t {
+
+  {
+    std::lock_guard lock{m_mutex};
+    const auto hash = m_package_hashes.find(package_name);
+
+    if (hash != m_package_hashes.end()) {
+      return hash->second;
+    }
+  }
+
+  // Missing package hashes to zero, entry is invalidated if it appears
+  std::uint64_t hash = 0;
+
+  if (const auto path = m_unreal_loader.package_path(package_name)) {
+    const utils::MappedFile file{path.value()};
+
+    if (file.valid()) {
+      hash = hash_bytes(file.data(), file.size());
+    }
+  }
+
+  std::lock_guard lock{m_mutex};
+  return m_package_hashes.try_emplace(package_name, hash).first->second;
+}
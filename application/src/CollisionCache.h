@@ -0,0 +1,41 @@
+#pragma once
+
+#include "UnrealLoader.h"
+
+#include <geodata/Map.h>
+
+#include <utils/NonCopyable.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Collision geometry of maps stored between runs, so unchanged maps skip
+// Unreal package parsing. Entry is valid while the packages the map was built
+// from (compared by content hash) and the cache version don't change.
+// Thread-safe.
+class CollisionCache : public utils::NonCopyable {
+public:
+  explicit CollisionCache(const std::filesystem::path &path,
+                          const UnrealLoader &unreal_loader);
+
+  auto load(const std::string &map_name) const -> std::optional<geodata::Map>;
+
+  void store(const geodata::Map &map,
+             const std::vector<std::string> &packages) const;
+
+private:
+  const std::filesystem::path m_path;
+  const UnrealLoader &m_unreal_loader;
+
+  // Package name to content hash, packages don't change during the run
+  mutable std::unordered_map<std::string, std::uint64_t> m_package_hashes;
+  mutable std::mutex m_mutex;
+
+  auto entry_path(const std::string &map_name) const -> std::filesystem::path;
+  auto package_hash(const std::string &package_name) const -> std::uint64_t;
+};
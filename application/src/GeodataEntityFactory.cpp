@@ -9,7 +9,7 @@ auto GeodataEntityFactory::make_entity(const geodata::Geodata &geodata,
 
   const auto mesh = std::make_shared<GeodataMesh>();
 
-  mesh->cells = geodata.cells;
+  mesh->cells.assign(geodata.cells.begin(), geodata.cells.end());
   mesh->bounding_box = geometry::Box{{0.0f, 0.0f, bounding_box.min().z},
                                      bounding_box.max() - bounding_box.min()};
 
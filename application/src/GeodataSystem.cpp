@@ -5,9 +5,10 @@
 #include "GeodataSystem.h"
 
 GeodataSystem::GeodataSystem(GeodataContext &geodata_context,
-                             UIContext &ui_context, const Renderer *renderer)
+                             UIContext &ui_context, const Renderer *renderer,
+                             std::size_t thread_count)
     : m_geodata_context{geodata_context}, m_ui_context{ui_context},
-      m_renderer{renderer} {
+      m_renderer{renderer}, m_geodata_builder{thread_count} {
 
   m_ui_context.geodata.build_handler = [this] { build(); };
 }
@@ -23,7 +24,6 @@ void GeodataSystem::build() const {
       m_ui_context.geodata.cell_height,
   };
 
-  geodata::Builder geodata_builder;
   geodata::Exporter geodata_exporter{"output"};
   GeodataEntityFactory geodata_entity_factory;
 
@@ -35,7 +35,7 @@ void GeodataSystem::build() const {
     utils::Log(utils::LOG_INFO, "App")
         << "Building geodata for map: " << map.name() << std::endl;
 
-    const auto &buffer = geodata_builder.build(map, settings);
+    const auto &buffer = m_geodata_builder.build(map, settings);
     const auto geodata_entity = geodata_entity_factory.make_entity(
         buffer.convert_to_geodata(), map.bounding_box(),
         SURFACE_GENERATED_GEODATA);
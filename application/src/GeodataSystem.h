@@ -6,15 +6,21 @@
 #include "Timestep.h"
 #include "UIContext.h"
 
+#include <geodata/Builder.h>
+
+#include <cstddef>
+
 class GeodataSystem : public System {
 public:
+  // Each map is built on thread_count threads
   explicit GeodataSystem(GeodataContext &geodata_context, UIContext &ui_context,
-                         const Renderer *renderer);
+                         const Renderer *renderer, std::size_t thread_count);
 
 private:
   GeodataContext &m_geodata_context;
   UIContext &m_ui_context;
   const Renderer *m_renderer;
+  const geodata::Builder m_geodata_builder;
 
   void build() const;
 };
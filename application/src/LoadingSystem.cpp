@@ -2,15 +2,15 @@
 
 #include "GeodataEntityFactory.h"
 #include "LoadingSystem.h"
-#include "UnrealLoader.h"
 
 LoadingSystem::LoadingSystem(GeodataContext &geodata_context,
                              const Renderer *renderer,
-                             const std::filesystem::path &root_path,
+                             const UnrealLoader &unreal_loader,
+                             const CollisionCache *collision_cache,
                              const std::vector<std::string> &map_names)
-    : m_geodata_context{geodata_context}, m_renderer{renderer} {
+    : m_geodata_context{geodata_context}, m_renderer{renderer},
+      m_collision_cache{collision_cache} {
 
-  UnrealLoader unreal_loader{root_path};
   geodata::Loader geodata_loader{"geodata"};
 
   GeodataEntityFactory geodata_entity_factory;
@@ -19,6 +19,18 @@ LoadingSystem::LoadingSystem(GeodataContext &geodata_context,
   std::vector<Entity<GeodataMesh>> geodata_entities;
 
   for (const auto &map_name : map_names) {
+    if (m_collision_cache != nullptr) {
+      auto cached_map = m_collision_cache->load(map_name);
+
+      if (cached_map.has_value()) {
+        utils::Log(utils::LOG_INFO, "App")
+            << "Map loaded from collision cache: " << map_name << std::endl;
+
+        m_geodata_context.maps.push_back(std::move(cached_map.value()));
+        continue;
+      }
+    }
+
     utils::Log(utils::LOG_INFO, "App")
         << "Loading map: " << map_name << std::endl;
 
@@ -121,6 +133,16 @@ void LoadingSystem::prebuild_maps(const std::vector<Map> &maps) const {
       geodata_map.add(geodata_entity);
     }
 
+#ifdef MORTON_ORDER
+    // Sorted once before storing, cache entries of sorted and unsorted maps
+    // differ in flags
+    geodata_map.sort_triangles();
+#endif
+
+    if (m_collision_cache != nullptr) {
+      m_collision_cache->store(geodata_map, map.packages);
+    }
+
     m_geodata_context.maps.push_back(std::move(geodata_map));
   }
 }
@@ -1,24 +1,29 @@
 #pragma once
 
+#include "CollisionCache.h"
 #include "GeodataContext.h"
 #include "Map.h"
 #include "Renderer.h"
 #include "System.h"
+#include "UnrealLoader.h"
 
-#include <filesystem>
 #include <string>
 #include <vector>
 
+// Maps found in the collision cache (if any) aren't loaded from packages and
+// aren't rendered, so the cache is meant for the CLI mode.
 class LoadingSystem : public System {
 public:
   explicit LoadingSystem(GeodataContext &geodata_context,
                          const Renderer *renderer,
-                         const std::filesystem::path &root_path,
+                         const UnrealLoader &unreal_loader,
+                         const CollisionCache *collision_cache,
                          const std::vector<std::string> &map_names);
 
 private:
   GeodataContext &m_geodata_context;
   const Renderer *m_renderer;
+  const CollisionCache *m_collision_cache;
 
   void prebuild_maps(const std::vector<Map> &maps) const;
 };
@@ -15,5 +15,9 @@ struct Map {
   glm::vec3 position;
   geometry::Box bounding_box;
 
-  explicit Map() : name{}, entities{}, position{}, bounding_box{} {}
+  // Packages the map is built from
+  std::vector<std::string> packages;
+
+  explicit Map()
+      : name{}, entities{}, position{}, bounding_box{}, packages{} {}
 };
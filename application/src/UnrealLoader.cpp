@@ -3,16 +3,21 @@
 #include "UnrealConverters.h"
 #include "UnrealLoader.h"
 
-UnrealLoader::UnrealLoader(const std::filesystem::path &root_path)
-    : m_package_loader{root_path,
+UnrealLoader::UnrealLoader(const std::filesystem::path &root_path,
+                           unreal::LoadProfile load_profile)
+    : m_load_profile{load_profile},
+      m_package_loader{root_path,
                        {unreal::SearchConfig{"Maps", "unr"},
                         unreal::SearchConfig{"StaticMeshes", "usx"},
                         unreal::SearchConfig{"Textures", "utx"},
-                        unreal::SearchConfig{"SysTextures", "utx"}}} {}
+                        unreal::SearchConfig{"SysTextures", "utx"}},
+                       load_profile},
+      m_job_pool{std::max(std::thread::hardware_concurrency(), 1u)} {}
 
 auto UnrealLoader::load_map(const std::string &name) const -> Map {
   Map map{};
 
+  use_map_package(name, name);
   const auto optional_package = m_package_loader.load_package(name);
 
   if (!optional_package.has_value()) {
@@ -21,15 +26,50 @@ auto UnrealLoader::load_map(const std::string &name) const -> Map {
 
   const auto package = optional_package.value();
 
+  // Static meshes (and textures, if they are used) are loaded while the map
+  // itself is processed. The terrain heightmap is needed right away, its
+  // package is loaded on this thread.
+#ifdef LOAD_TEXTURES
+  const auto imported_packages = package.imported_packages();
+#else
+  const auto imported_packages = package.imported_packages({"StaticMesh"});
+#endif
+
+  m_package_loader.prefetch_packages(imported_packages);
+
+  map.packages.push_back(name);
+  map.packages.insert(map.packages.end(), imported_packages.begin(),
+                      imported_packages.end());
+
   // Terrain
   const auto terrain = load_terrain(package);
 
+  // Heightmap is the only texture used by the collision geometry
+  const auto terrain_map_package = terrain->terrain_map->package_name();
+
+  if (std::find(map.packages.begin(), map.packages.end(),
+                terrain_map_package) == map.packages.end()) {
+    map.packages.push_back(terrain_map_package);
+  }
+
   map.position = to_vec3(terrain->position());
   const auto scale = to_vec3(terrain->scale());
   map.bounding_box = geometry::Box{
       to_vec3(terrain->bounding_box().min) * scale + map.position,
       to_vec3(terrain->bounding_box().max) * scale + map.position};
 
+  // Side terrains are stitched to the map terrain
+  const std::string side_packages[] = {
+      map_package_name(terrain->map_x + 1, terrain->map_y),
+      map_package_name(terrain->map_x, terrain->map_y + 1),
+      map_package_name(terrain->map_x + 1, terrain->map_y + 1),
+  };
+
+  for (const auto &side_package : side_packages) {
+    map.packages.push_back(side_package);
+    use_map_package(name, side_package);
+  }
+
 #ifdef LOAD_TERRAIN
   if (!terrain->broken_scale()) {
     const auto terrain_entities = load_terrain_entities(*terrain);
@@ -60,13 +100,51 @@ auto UnrealLoader::load_map(const std::string &name) const -> Map {
   return map;
 }
 
-auto UnrealLoader::load_map_package(int x, int y) const
-    -> std::optional<unreal::Package> {
+void UnrealLoader::unload_map_packages(const std::string &name) const {
+  std::lock_guard lock{m_mutex};
+
+  const auto map_packages = m_map_packages.find(name);
 
+  if (map_packages == m_map_packages.end()) {
+    return;
+  }
+
+  // Unloaded under the lock, so no other map can start using the package.
+  // Unloading doesn't wait for packages still prefetched for other maps.
+  for (const auto &package_name : map_packages->second) {
+    if (--m_map_package_users[package_name] == 0) {
+      m_map_package_users.erase(package_name);
+      m_package_loader.unload_package(package_name);
+    }
+  }
+
+  m_map_packages.erase(map_packages);
+}
+
+auto UnrealLoader::package_path(const std::string &name) const
+    -> std::optional<std::filesystem::path> {
+
+  return m_package_loader.package_path(name);
+}
+
+auto UnrealLoader::map_package_name(int x, int y) const -> std::string {
   std::stringstream stream;
   stream << x << "_" << y;
-  const auto package_name = stream.str();
+  return stream.str();
+}
+
+void UnrealLoader::use_map_package(const std::string &name,
+                                   const std::string &package_name) const {
+
+  std::lock_guard lock{m_mutex};
+  m_map_packages[name].push_back(package_name);
+  m_map_package_users[package_name]++;
+}
 
+auto UnrealLoader::load_map_package(int x, int y) const
+    -> std::optional<unreal::Package> {
+
+  const auto package_name = map_package_name(x, y);
   const auto package = m_package_loader.load_package(package_name);
   return package;
 }
@@ -361,9 +439,26 @@ auto UnrealLoader::load_mesh_actor_entities(
   std::vector<Entity<EntityMesh>> entities;
 
   std::vector<std::shared_ptr<unreal::StaticMeshActor>> mesh_actors;
-  package.load_objects("StaticMeshActor", mesh_actors);
-  package.load_objects("MovableStaticMeshActor", mesh_actors);
-  package.load_objects("L2MovableStaticMeshActor", mesh_actors);
+  package.load_objects("StaticMeshActor", mesh_actors, m_job_pool);
+  package.load_objects("MovableStaticMeshActor", mesh_actors, m_job_pool);
+  package.load_objects("L2MovableStaticMeshActor", mesh_actors, m_job_pool);
+
+  // Deserialize static meshes in parallel too, conversion below is sequential
+  // and only takes them from the export cache
+  utils::JobPool::Batch batch;
+
+  for (const auto &mesh_actor : mesh_actors) {
+    m_job_pool.submit(
+        [&mesh_actor](std::size_t) {
+          if (!mesh_actor->delete_me && !mesh_actor->hidden) {
+            [[maybe_unused]] const std::shared_ptr<unreal::StaticMesh> mesh =
+                mesh_actor->static_mesh;
+          }
+        },
+        batch);
+  }
+
+  m_job_pool.wait(batch);
 
   for (const auto &mesh_actor : mesh_actors) {
     if (mesh_actor->delete_me || mesh_actor->hidden) {
@@ -382,31 +477,63 @@ auto UnrealLoader::load_mesh_actor_entities(
     const auto bounding_box = to_box(unreal_mesh->bounding_box);
 
     const auto &mesh_name = unreal_mesh->full_name();
-    auto cached_mesh = m_mesh_cache.find(mesh_name);
-    auto cached_bb_mesh = m_bb_mesh_cache.find(mesh_name);
+    std::shared_ptr<EntityMesh> mesh;
+    std::shared_ptr<EntityMesh> bb_mesh;
 
-    if (cached_bb_mesh == m_bb_mesh_cache.end()) {
-      const auto bb_mesh = bounding_box_mesh(SURFACE_STATIC_MESH, bounding_box);
-      cached_bb_mesh = m_bb_mesh_cache.insert({mesh_name, bb_mesh}).first;
+    // Passable surfaces depend on the collision flags of the actor, meshes
+    // placed by blocking and non-blocking actors are cached apart
+    const auto mesh_key =
+        collides(*mesh_actor) ? mesh_name : mesh_name + ":passable";
+
+    {
+      std::lock_guard lock{m_mutex};
+
+      if (const auto cached_mesh = m_mesh_cache.find(mesh_key);
+          cached_mesh != m_mesh_cache.end()) {
+        mesh = cached_mesh->second;
+      }
+
+      if (const auto cached_bb_mesh = m_bb_mesh_cache.find(mesh_name);
+          cached_bb_mesh != m_bb_mesh_cache.end()) {
+        bb_mesh = cached_bb_mesh->second;
+      }
     }
 
-    if (cached_mesh == m_mesh_cache.end()) {
-      const auto mesh = std::make_shared<EntityMesh>();
-      cached_mesh = m_mesh_cache.insert({mesh_name, mesh}).first;
+    // Meshes are converted outside of the lock, if several maps convert the
+    // same mesh at once, the first cached copy is used (copies are equal)
+    if (bb_mesh == nullptr) {
+      bb_mesh = bounding_box_mesh(SURFACE_STATIC_MESH, bounding_box);
+
+      std::lock_guard lock{m_mutex};
+      bb_mesh = m_bb_mesh_cache.try_emplace(mesh_name, bb_mesh).first->second;
+    }
+
+    if (mesh == nullptr) {
+      mesh = std::make_shared<EntityMesh>();
 
       // Bounding box
       mesh->bounding_box = bounding_box;
 
-      ASSERT(!unreal_mesh->uv_stream.empty(), "App",
+      // Texture coordinates aren't loaded with the collision profile
+      const auto has_uvs = m_load_profile == unreal::LoadProfile::Full;
+
+      ASSERT(!has_uvs || !unreal_mesh->uv_stream.empty(), "App",
              "Surface doesn't have texture coordinates");
-      auto uvs = unreal_mesh->uv_stream[0].uvs.begin();
 
       // Vertices
-      for (const auto &vertex : unreal_mesh->vertex_stream.vertices) {
-        mesh->vertices.push_back({to_vec3(vertex.location),
-                                  to_vec3(vertex.normal),
-                                  {uvs->u, uvs->v}});
-        ++uvs;
+      for (std::size_t i = 0; i < unreal_mesh->vertex_stream.vertices.size();
+           ++i) {
+
+        const auto &vertex = unreal_mesh->vertex_stream.vertices[i];
+        glm::vec2 uv{};
+
+        if (has_uvs) {
+          const auto &unreal_uv = unreal_mesh->uv_stream[0].uvs[i];
+          uv = {unreal_uv.u, unreal_uv.v};
+        }
+
+        mesh->vertices.push_back(
+            {to_vec3(vertex.location), to_vec3(vertex.normal), uv});
       }
 
       // Surfaces
@@ -454,15 +581,18 @@ auto UnrealLoader::load_mesh_actor_entities(
 
         mesh->surfaces.push_back(surface);
       }
+
+      std::lock_guard lock{m_mutex};
+      mesh = m_mesh_cache.try_emplace(mesh_key, mesh).first->second;
     }
 
     // Static mesh entity
-    Entity entity{cached_mesh->second};
+    Entity entity{mesh};
     place_actor(*mesh_actor, entity);
     entities.push_back(std::move(entity));
 
     // Bounding box entity
-    Entity bb_entity{cached_bb_mesh->second};
+    Entity bb_entity{bb_mesh};
     bb_entity.wireframe = true;
     place_actor(*mesh_actor, bb_entity);
     entities.push_back(std::move(bb_entity));
@@ -644,16 +774,18 @@ void UnrealLoader::place_actor(const unreal::Actor &actor,
 
 // Reference:
 // https://docs.unrealengine.com/udk/Two/StaticMeshCollisionReference.html
+auto UnrealLoader::collides(const unreal::StaticMeshActor &mesh_actor) const
+    -> bool {
+
+  return mesh_actor.collide_actors && mesh_actor.block_actors &&
+         mesh_actor.block_players;
+}
+
 auto UnrealLoader::collides(const unreal::StaticMeshActor &mesh_actor,
                             const unreal::StaticMeshMaterial &material) const
     -> bool {
 
-  if (!mesh_actor.collide_actors || !mesh_actor.block_actors ||
-      !mesh_actor.block_players) {
-    return false;
-  }
-
-  return material.enable_collision;
+  return collides(mesh_actor) && material.enable_collision;
 }
 
 auto UnrealLoader::bounding_box_mesh(std::uint64_t type,
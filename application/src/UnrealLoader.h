@@ -13,27 +13,63 @@
 
 #include <geometry/Box.h>
 
+#include <utils/JobPool.h>
+#include <utils/NonCopyable.h>
+
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-class UnrealLoader {
+// Can be shared between maps (and threads): loaded packages and converted
+// meshes are cached for the whole loader lifetime. With the collision profile
+// meshes have no texture coordinates and textures have no mips (except
+// terrain heightmaps), so loaded maps are good only for geodata building.
+class UnrealLoader : public utils::NonCopyable {
 public:
-  explicit UnrealLoader(const std::filesystem::path &root_path);
+  explicit UnrealLoader(const std::filesystem::path &root_path,
+                        unreal::LoadProfile load_profile);
 
   auto load_map(const std::string &name) const -> Map;
 
+  // Map packages are rarely shared between maps, unload packages of the loaded
+  // map to keep memory usage flat on large batches. Packages still used by
+  // other maps are kept. Textures loaded from unloaded packages become invalid.
+  void unload_map_packages(const std::string &name) const;
+
+  auto package_path(const std::string &name) const
+      -> std::optional<std::filesystem::path>;
+
 private:
+  const unreal::LoadProfile m_load_profile;
   unreal::PackageLoader m_package_loader;
 
+  // Meshes are keyed by full name (package and object name), passable copies
+  // of non-blocking actors get a suffix
   mutable std::unordered_map<std::string, std::shared_ptr<EntityMesh>>
       m_mesh_cache;
   mutable std::unordered_map<std::string, std::shared_ptr<EntityMesh>>
       m_bb_mesh_cache;
 
+  // Map packages (own and side terrains) of every loaded map and the number of
+  // maps using each package
+  mutable std::unordered_map<std::string, std::vector<std::string>>
+      m_map_packages;
+  mutable std::unordered_map<std::string, int> m_map_package_users;
+
+  // Guards the mesh caches and map package lists only, maps are loaded in
+  // parallel
+  mutable std::mutex m_mutex;
+
+  // Deserializes objects of the maps being loaded, shared by all of them
+  mutable utils::JobPool m_job_pool;
+
+  auto map_package_name(int x, int y) const -> std::string;
+  void use_map_package(const std::string &name,
+                       const std::string &package_name) const;
   auto load_map_package(int x, int y) const -> std::optional<unreal::Package>;
   auto load_terrain(const unreal::Package &package) const
       -> std::shared_ptr<unreal::TerrainInfoActor>;
@@ -59,6 +95,7 @@ private:
   void place_actor(const unreal::Actor &actor,
                    Entity<EntityMesh> &entity) const;
 
+  auto collides(const unreal::StaticMeshActor &mesh_actor) const -> bool;
   auto collides(const unreal::StaticMeshActor &mesh_actor,
                 const unreal::StaticMeshMaterial &material) const -> bool;
 
@@ -15,6 +15,11 @@ auto main(int argc, char **argv) -> int {
                                                                              //
       ("build", "Build maps (see results in the `output` directory)")        //
                                                                              //
+      ("jobs", "Number of maps built in parallel (build only)",              //
+       cxxopts::value<std::size_t>()->default_value("1"))                    //
+                                                                             //
+      ("no-cache", "Don't use collision cache (build only)")                 //
+                                                                             //
       ("client-root", "Path to the Lineage II client",                       //
        cxxopts::value<std::filesystem::path>())                              //
                                                                              //
@@ -77,12 +82,20 @@ auto main(int argc, char **argv) -> int {
     return EXIT_FAILURE;
   }
 
+  // Jobs
+  const auto jobs = input["jobs"].as<std::size_t>();
+  if (jobs == 0) {
+    utils::Log(utils::LOG_ERROR)
+        << "Invalid jobs number: " << jobs << std::endl;
+    return EXIT_FAILURE;
+  }
+
   // Run application
   const Application application;
   if (preview) {
     application.preview(client_root, maps);
   } else if (build) {
-    application.build(client_root, maps);
+    application.build(client_root, maps, jobs, input.count("no-cache") == 0);
   } else {
     ASSERT(false, "App", "Unknown command");
   }
@@ -34,6 +34,7 @@
 #include <geodata/Map.h>
 
 #include <utils/Assert.h>
+#include <utils/JobPool.h>
 #include <utils/Log.h>
 #include <utils/NonCopyable.h>
 
@@ -53,6 +54,7 @@
 
 #include <cxxopts.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
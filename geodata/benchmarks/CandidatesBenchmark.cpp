@@ -0,0 +1,290 @@
+#include "pch.h"
+
+#include "TriangleCandidates.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <unordered_set>
+
+// Compares ways of handing collision candidates to the complex NSWE loops:
+// - copy: neighbour column lists merged and copied into new triangles per
+//   query (the original triangles_at_columns)
+// - cache: triangle copies cached per column, returned by reference
+// - view: triangle indices in a flat per-column store, seen through
+//   TriangleCandidates
+// - intervals: the same view with the span intervals recorded by the
+//   rasterizer, as the stepping collision path uses it
+// Every query runs the same sphere scans, so the difference is allocation,
+// copy and candidate filtering time.
+//
+// Usage: geodata-candidates-benchmark [grid size] [triangles per column]
+
+static constexpr auto ITERATIONS = 5;
+static constexpr auto CELL_SIZE = 16.0f;
+static constexpr auto FETCH_RADIUS = 2;
+static constexpr auto SCANS_PER_QUERY = 24;
+
+static std::atomic<std::size_t> allocations = 0;
+
+auto operator new(std::size_t size) -> void * {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (auto *pointer = std::malloc(size != 0 ? size : 1)) {
+    return pointer;
+  }
+
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+struct Mesh {
+  int size;
+  std::vector<glm::vec3> vertices;
+  std::vector<unsigned int> indices;
+  std::vector<std::vector<int>> columns; // Triangles overlapping a column
+};
+
+// Random triangles no larger than a column, like dense static meshes. Spheres
+// are dropped from above, so most scans go through all candidates.
+static auto make_mesh(int size, int triangles_per_column) -> Mesh {
+  std::mt19937 random{42};
+  std::uniform_real_distribution<float> offset{0.0f, CELL_SIZE};
+  std::uniform_real_distribution<float> height{0.0f, 64.0f};
+
+  Mesh mesh{size, {}, {}, std::vector<std::vector<int>>(size * size)};
+
+  for (auto y = 0; y < size; ++y) {
+    for (auto x = 0; x < size; ++x) {
+      for (auto i = 0; i < triangles_per_column; ++i) {
+        const auto triangle = static_cast<int>(mesh.indices.size() / 3);
+
+        for (auto j = 0; j < 3; ++j) {
+          mesh.indices.push_back(
+              static_cast<unsigned int>(mesh.vertices.size()));
+          mesh.vertices.emplace_back(x * CELL_SIZE + offset(random),
+                                     height(random),
+                                     y * CELL_SIZE + offset(random));
+        }
+
+        mesh.columns[x + y * size].push_back(triangle);
+      }
+    }
+  }
+
+  return mesh;
+}
+
+static auto make_triangle(const Mesh &mesh, int index) -> geometry::Triangle {
+  return geometry::Triangle{
+      mesh.vertices[mesh.indices[index * 3 + 0]],
+      mesh.vertices[mesh.indices[index * 3 + 1]],
+      mesh.vertices[mesh.indices[index * 3 + 2]],
+  };
+}
+
+static auto collect_triangles(const Mesh &mesh, int x, int y)
+    -> std::vector<int> {
+
+  std::vector<int> triangles;
+
+  for (auto dy = y - FETCH_RADIUS; dy <= y + FETCH_RADIUS; ++dy) {
+    for (auto dx = x - FETCH_RADIUS; dx <= x + FETCH_RADIUS; ++dx) {
+      if (dx >= 0 && dy >= 0 && dx < mesh.size && dy < mesh.size) {
+        const auto &column = mesh.columns[dx + dy * mesh.size];
+        triangles.insert(triangles.end(), column.begin(), column.end());
+      }
+    }
+  }
+
+  std::sort(triangles.begin(), triangles.end());
+  triangles.erase(std::unique(triangles.begin(), triangles.end()),
+                  triangles.end());
+
+  return triangles;
+}
+
+// Vertical extent of the triangle in heightfield cells (of unit height),
+// floored and ceiled like the rasterizer does
+static auto triangle_interval(const Mesh &mesh, int index)
+    -> geodata::ColumnTriangle {
+
+  const auto triangle = make_triangle(mesh, index);
+  const auto bottom = std::min({triangle.a.y, triangle.b.y, triangle.c.y});
+  const auto top = std::max({triangle.a.y, triangle.b.y, triangle.c.y});
+
+  return {index, static_cast<std::uint16_t>(std::floor(bottom)),
+          static_cast<std::uint16_t>(std::ceil(top))};
+}
+
+static auto sphere_at(int x, int y, int scan) -> geometry::Sphere {
+  return geometry::Sphere{{x * CELL_SIZE + scan * 0.5f, 96.0f - scan,
+                           y * CELL_SIZE + CELL_SIZE / 2.0f},
+                          16.0f};
+}
+
+static auto scan(const std::vector<geometry::Triangle> &triangles, int x,
+                 int y) -> int {
+
+  auto hits = 0;
+
+  for (auto i = 0; i < SCANS_PER_QUERY; ++i) {
+    hits += sphere_at(x, y, i).intersects(triangles) ? 1 : 0;
+  }
+
+  return hits;
+}
+
+static auto scan(const geodata::TriangleCandidates &triangles, int x, int y)
+    -> int {
+
+  auto hits = 0;
+
+  for (auto i = 0; i < SCANS_PER_QUERY; ++i) {
+    hits += triangles.intersects(sphere_at(x, y, i)) ? 1 : 0;
+  }
+
+  return hits;
+}
+
+struct Result {
+  double time;
+  std::size_t allocations;
+  int hits;
+};
+
+template <typename F> static auto measure(const Mesh &mesh, F &&query) {
+  Result best{std::numeric_limits<double>::max(), 0, 0};
+
+  for (auto i = 0; i < ITERATIONS; ++i) {
+    const auto allocations_before = allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    auto hits = 0;
+
+    for (auto y = 0; y < mesh.size; ++y) {
+      for (auto x = 0; x < mesh.size; ++x) {
+        hits += query(x, y);
+      }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const auto time = std::chrono::duration<double>(end - start).count();
+
+    if (time < best.time) {
+      best = {time, allocations.load() - allocations_before, hits};
+    }
+  }
+
+  return best;
+}
+
+static void print(const char *name, const Result &result) {
+  std::cout << "  " << name << ": " << result.time * 1000.0 << " ms, "
+            << result.allocations << " allocations, " << result.hits
+            << " hits" << std::endl;
+}
+
+auto main(int argc, char **argv) -> int {
+  const auto size = argc > 1 ? std::atoi(argv[1]) : 128;
+  const auto triangles_per_column = argc > 2 ? std::atoi(argv[2]) : 8;
+
+  if (size <= 0 || triangles_per_column <= 0) {
+    std::cout << "Usage: " << argv[0]
+              << " [grid size] [triangles per column]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto mesh = make_mesh(size, triangles_per_column);
+
+  std::cout << size << "x" << size << " columns, " << triangles_per_column
+            << " triangles per column" << std::endl;
+
+  const auto copy = measure(mesh, [&mesh](int x, int y) {
+    std::unordered_set<int> indices;
+
+    for (const auto index : collect_triangles(mesh, x, y)) {
+      indices.insert(index);
+    }
+
+    std::vector<geometry::Triangle> triangles;
+
+    for (const auto index : indices) {
+      triangles.push_back(make_triangle(mesh, index));
+    }
+
+    return scan(triangles, x, y);
+  });
+
+  print("copy", copy);
+
+  // Both stores are filled up front, queries only read them
+  std::vector<std::vector<geometry::Triangle>> cache(size * size);
+
+  for (auto y = 0; y < size; ++y) {
+    for (auto x = 0; x < size; ++x) {
+      for (const auto index : collect_triangles(mesh, x, y)) {
+        cache[x + y * size].push_back(make_triangle(mesh, index));
+      }
+    }
+  }
+
+  const auto cached = measure(mesh, [&cache, size](int x, int y) {
+    return scan(cache[x + y * size], x, y);
+  });
+
+  print("cache", cached);
+
+  // Full intervals for the plain view, so no candidate is skipped
+  std::vector<std::uint32_t> offsets{0};
+  std::vector<geodata::ColumnTriangle> values;
+  std::vector<geodata::ColumnTriangle> intervals;
+
+  for (auto y = 0; y < size; ++y) {
+    for (auto x = 0; x < size; ++x) {
+      for (const auto index : collect_triangles(mesh, x, y)) {
+        values.push_back({index, 0, std::numeric_limits<std::uint16_t>::max()});
+        intervals.push_back(triangle_interval(mesh, index));
+      }
+
+      offsets.push_back(static_cast<std::uint32_t>(values.size()));
+    }
+  }
+
+  const auto view_of = [&](const std::vector<geodata::ColumnTriangle> &store,
+                           int x, int y) {
+    const auto column = x + y * size;
+    const std::span<const geodata::ColumnTriangle> triangles{
+        store.data() + offsets[column], offsets[column + 1] - offsets[column]};
+
+    return geodata::TriangleCandidates{triangles, mesh.vertices, mesh.indices,
+                                       0.0f, 1.0f};
+  };
+
+  const auto view = measure(mesh, [&](int x, int y) {
+    return scan(view_of(values, x, y), x, y);
+  });
+
+  print("view", view);
+
+  const auto filtered = measure(mesh, [&](int x, int y) {
+    return scan(view_of(intervals, x, y), x, y);
+  });
+
+  print("intervals", filtered);
+
+  std::cout << "  cache memory: "
+            << values.size() * sizeof(geometry::Triangle) / 1024 << " KB"
+            << " (triangles), "
+            << (values.size() * sizeof(geodata::ColumnTriangle) +
+                offsets.size() * sizeof(std::uint32_t)) /
+                   1024
+            << " KB (indices)" << std::endl;
+
+  return EXIT_SUCCESS;
+}
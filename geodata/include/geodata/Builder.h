@@ -5,15 +5,27 @@
 #include "Geodata.h"
 #include "Map.h"
 
+#include <utils/Arena.h>
+#include <utils/JobPool.h>
+
+#include <cstddef>
+
 namespace geodata {
 
 class Builder {
 public:
+  // Collision detection of a map is spread over thread_count threads
+  explicit Builder(std::size_t thread_count);
+
   auto build(const Map &map, const BuilderSettings &settings) const
       -> const ExportBuffer &;
 
 private:
   mutable ExportBuffer m_export_buffer;
+  mutable utils::JobPool m_job_pool;
+
+  // Memory of a map build, reset before the next map
+  mutable utils::Arena m_arena;
 };
 
 } // namespace geodata
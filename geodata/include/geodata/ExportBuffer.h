@@ -7,6 +7,9 @@
 
 namespace geodata {
 
+// Cells of a map grouped by blocks and columns. Layers are stored sparsely:
+// cells of all columns are kept in one array, column cells start at the prefix
+// sum of the layer counts of the previous columns.
 class ExportBuffer {
 public:
   struct Block {
@@ -42,8 +45,11 @@ public:
 private:
   std::vector<Block> m_blocks;
   std::vector<Column> m_columns;
+  std::vector<std::uint32_t> m_offsets; // Index of the first column cell
   std::vector<PackedCell> m_cells;
 
+  auto column_index(int x, int y, int cx, int cy) const -> int;
+
   auto pack_cell(const Cell &cell) const -> PackedCell;
   auto unpack_cell(PackedCell packed_cell, BlockType type, int x, int y) const
       -> Cell;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace geodata {
@@ -30,7 +31,7 @@ struct Cell {
 };
 
 struct Geodata {
-  std::vector<Cell> cells;
+  std::pmr::vector<Cell> cells;
 };
 
 } // namespace geodata
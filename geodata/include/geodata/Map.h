@@ -21,10 +21,21 @@ namespace geodata {
 class Map : public utils::NonCopyable {
 public:
   explicit Map(const std::string &name, const geometry::Box &bounding_box);
+
+  // Vertices and indices are already converted (see vertices() and indices())
+  explicit Map(const std::string &name, const geometry::Box &bounding_box,
+               std::vector<glm::vec3> vertices,
+               std::vector<unsigned int> indices);
   Map(Map &&other) noexcept;
 
   void add(const Entity &entity);
 
+  // Reorders triangles along a Z-order curve of their centroids (horizontal
+  // plane) and renumbers vertices in order of first use. Triangles of nearby
+  // columns end up close in memory, and so do their vertices. Unreferenced
+  // vertices are dropped.
+  void sort_triangles();
+
   auto name() const -> const std::string &;
   auto bounding_box() const -> geometry::Box;
 
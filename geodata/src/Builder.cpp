@@ -2,14 +2,23 @@
 
 #include "Compressor.h"
 #include "NSWE.h"
+#include "RecastAllocator.h"
 
 #include <geodata/Builder.h>
 
 namespace geodata {
 
+Builder::Builder(std::size_t thread_count) : m_job_pool{thread_count} {
+  install_recast_allocator();
+}
+
 auto Builder::build(const Map &map, const BuilderSettings &settings) const
     -> const ExportBuffer & {
 
+  // Nothing of the previous map is alive, its memory is taken back at once
+  m_arena.reset();
+  const utils::Arena::Scope arena_scope{m_arena};
+
   NSWE nswe_calculator{
       map,
       settings.actor_height,
@@ -19,12 +28,14 @@ auto Builder::build(const Map &map, const BuilderSettings &settings) const
       settings.max_walkable_climb,
       settings.cell_size,
       settings.cell_height,
+      m_job_pool,
+      m_arena,
   };
 
   const auto &hf = nswe_calculator.calculate_nswe();
 
   // Convert heightfield to geodata
-  Geodata geodata;
+  Geodata geodata{std::pmr::vector<Cell>{&m_arena}};
 
   const auto map_origin = map.bounding_box().min();
 
@@ -34,16 +45,18 @@ auto Builder::build(const Map &map, const BuilderSettings &settings) const
   const auto cell_elevation = map_origin.z + settings.cell_height;
 #endif
 
-  std::vector<int> columns(hf.width * hf.height);
+  std::pmr::vector<int> columns(hf.width * hf.height, &m_arena);
   auto black_holes = 0;
 
   for (auto y = 0; y < hf.height; ++y) {
     for (auto x = 0; x < hf.width; ++x) {
-      for (auto *span = hf.spans[x + y * hf.width]; span != nullptr;
-           span = span->next) {
+      const auto column = x + y * hf.width;
+
+      for (auto span = hf.column_begin(column); span < hf.column_end(column);
+           ++span) {
 
-        const auto area = unpack_area(span->area);
-        const auto nswe = unpack_nswe(span->area);
+        const auto area = unpack_area(hf.areas[span]);
+        const auto nswe = unpack_nswe(hf.areas[span]);
 
         if (area == RC_NULL_AREA) {
           continue;
@@ -57,7 +70,7 @@ auto Builder::build(const Map &map, const BuilderSettings &settings) const
             static_cast<std::int16_t>(x), //
             static_cast<std::int16_t>(y), //
             static_cast<std::int16_t>(cell_elevation +
-                                      span->smax * settings.cell_height), //
+                                      hf.smax[span] * settings.cell_height), //
             BLOCK_MULTILAYER,                                             //
             (nswe & DIRECTION_N) != 0,                                    //
             (nswe & DIRECTION_W) != 0,                                    //
@@ -0,0 +1,208 @@
+#include "pch.h"
+
+#include "DistanceField.h"
+
+namespace geodata {
+
+DistanceField::DistanceField(const std::vector<glm::vec3> &vertices,
+                             const std::vector<unsigned int> &indices,
+                             float voxel_size, float band,
+                             const std::function<bool(float, float)> &region)
+    : m_vertices{&vertices}, m_indices{&indices}, m_voxel_size{voxel_size},
+      m_band{band}, m_error{voxel_size * std::sqrt(3.0f) / 2.0f} {
+
+  ASSERT(voxel_size > 0.0f && band > 0.0f, "Geodata",
+         "Distance field voxel size and band must be positive");
+
+  // Voxels store floored distances from their centers, so only the distance
+  // between a point and the center of its voxel adds to the error
+  const auto quantize = [band](float distance) {
+    return static_cast<std::uint8_t>(distance / band * 255.0f);
+  };
+
+  const auto voxel_center = [voxel_size](int voxel) {
+    return (static_cast<float>(voxel) + 0.5f) * voxel_size;
+  };
+
+  const auto to_voxel = [voxel_size](float coordinate) {
+    return static_cast<int>(std::floor(coordinate / voxel_size));
+  };
+
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const geometry::Triangle triangle{
+        vertices[indices[i + 0]],
+        vertices[indices[i + 1]],
+        vertices[indices[i + 2]],
+    };
+
+    const auto min =
+        glm::min(glm::min(triangle.a, triangle.b), triangle.c) - band;
+    const auto max =
+        glm::max(glm::max(triangle.a, triangle.b), triangle.c) + band;
+
+    for (auto x = to_voxel(min.x); x <= to_voxel(max.x); ++x) {
+      for (auto z = to_voxel(min.z); z <= to_voxel(max.z); ++z) {
+        if (!region(voxel_center(x), voxel_center(z))) {
+          continue;
+        }
+
+        for (auto y = to_voxel(min.y); y <= to_voxel(max.y); ++y) {
+          const glm::vec3 center{voxel_center(x), voxel_center(y),
+                                 voxel_center(z)};
+          const auto distance =
+              glm::distance(center, triangle.closest_point_to(center));
+
+          if (distance >= band) {
+            continue;
+          }
+
+          const auto [brick, inserted] = m_brick_index.try_emplace(
+              brick_key(x, y, z), static_cast<std::uint32_t>(m_bricks.size()));
+
+          if (inserted) {
+            m_bricks.emplace_back();
+            m_bricks.back().distances.fill(255);
+            m_bricks.back().triangles.fill(NO_TRIANGLE);
+          }
+
+          auto &voxel_brick = m_bricks[brick->second];
+          const auto offset = voxel_offset(x, y, z);
+          const auto value = quantize(distance);
+
+          if (value < voxel_brick.distances[offset] ||
+              voxel_brick.triangles[offset] == NO_TRIANGLE) {
+
+            voxel_brick.distances[offset] = value;
+            voxel_brick.triangles[offset] = static_cast<std::uint32_t>(i / 3);
+          }
+        }
+      }
+    }
+  }
+}
+
+auto DistanceField::distance(const glm::vec3 &point) const -> float {
+  const auto voxel = glm::floor(point / m_voxel_size);
+  const auto x = static_cast<int>(voxel.x);
+  const auto y = static_cast<int>(voxel.y);
+  const auto z = static_cast<int>(voxel.z);
+
+  const auto *brick = find_brick(x, y, z);
+  const auto value = brick != nullptr
+                         ? brick->distances[voxel_offset(x, y, z)]
+                         : std::uint8_t{255};
+
+  return std::max(0.0f, value * m_band / 255.0f - m_error);
+}
+
+auto DistanceField::intersects(const geometry::Sphere &sphere) const -> bool {
+  return distance(sphere.center) <= sphere.radius;
+}
+
+auto DistanceField::sweep(const geometry::Sphere &sphere,
+                          const glm::vec3 &movement,
+                          geometry::SweepIntersection &intersection) const
+    -> bool {
+
+  const auto length = glm::length(movement);
+  const auto min_step = m_voxel_size / 4.0f;
+
+  // Contact is taken a step early, so a step never ends inside a triangle
+  const auto contact_distance = sphere.radius + min_step;
+
+  auto time = 0.0f;
+  auto free_time = 0.0f;
+
+  while (true) {
+    const auto center = sphere.center + movement * time;
+    const auto gap = distance(center) - sphere.radius;
+
+    if (gap <= 0.0f) {
+      // Nearest triangles of the voxels around the center, only the ones the
+      // sphere moves towards
+      const auto base = glm::floor(center / m_voxel_size - 0.5f);
+      auto nearest = contact_distance * contact_distance;
+      glm::vec3 normal{};
+
+      for (auto i = 0; i < 8; ++i) {
+        const auto x = static_cast<int>(base.x) + (i & 1);
+        const auto y = static_cast<int>(base.y) + (i >> 1 & 1);
+        const auto z = static_cast<int>(base.z) + (i >> 2 & 1);
+
+        const auto *brick = find_brick(x, y, z);
+
+        if (brick == nullptr) {
+          continue;
+        }
+
+        const auto index = brick->triangles[voxel_offset(x, y, z)];
+
+        if (index == NO_TRIANGLE) {
+          continue;
+        }
+
+        const auto offset = center - triangle(index).closest_point_to(center);
+        const auto distance_squared = glm::dot(offset, offset);
+
+        // Cosine threshold keeps rounding errors of sliding contacts out
+        if (distance_squared > 0.0f && distance_squared <= nearest &&
+            glm::dot(offset, movement) <
+                -0.001f * std::sqrt(distance_squared) * length) {
+
+          nearest = distance_squared;
+          normal = offset;
+        }
+      }
+
+      if (glm::dot(normal, normal) > 0.0f) {
+        intersection.normal = glm::normalize(normal);
+        intersection.time = free_time;
+        return true;
+      }
+    }
+
+    free_time = time;
+
+    if (time >= 1.0f || length == 0.0f) {
+      return false;
+    }
+
+    time = std::min(1.0f, time + std::max(gap, min_step) / length);
+  }
+}
+
+auto DistanceField::find_brick(int x, int y, int z) const -> const Brick * {
+  const auto brick = m_brick_index.find(brick_key(x, y, z));
+  return brick != m_brick_index.end() ? &m_bricks[brick->second] : nullptr;
+}
+
+auto DistanceField::triangle(std::uint32_t index) const -> geometry::Triangle {
+  const auto &vertices = *m_vertices;
+  const auto &indices = *m_indices;
+
+  return geometry::Triangle{
+      vertices[indices[index * 3 + 0]],
+      vertices[indices[index * 3 + 1]],
+      vertices[indices[index * 3 + 2]],
+  };
+}
+
+auto DistanceField::brick_key(int x, int y, int z) -> std::uint64_t {
+  // 21 bits per brick coordinate
+  static constexpr auto bias = 1 << 20;
+  static constexpr auto mask = (std::uint64_t{1} << 21) - 1;
+
+  const auto coordinate = [](int voxel) {
+    return static_cast<std::uint64_t>((voxel >> 3) + bias) & mask;
+  };
+
+  return coordinate(x) | coordinate(y) << 21 | coordinate(z) << 42;
+}
+
+auto DistanceField::voxel_offset(int x, int y, int z) -> int {
+  static constexpr auto mask = BRICK_SIZE - 1;
+  return (x & mask) + (y & mask) * BRICK_SIZE +
+         (z & mask) * BRICK_SIZE * BRICK_SIZE;
+}
+
+} // namespace geodata
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <geometry/Intersection.h>
+#include <geometry/Sphere.h>
+#include <geometry/Triangle.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace geodata {
+
+// Sparse narrow-band unsigned distance field of a triangle mesh. Voxels are
+// grouped into 8x8x8 bricks, only bricks near triangles are allocated. A voxel
+// keeps the distance from its center to the nearest triangle (clamped to the
+// band and quantized to a byte) and the index of that triangle. Lookups return
+// a lower bound of the distance to the mesh, so a sphere reported free doesn't
+// touch any triangle, and the cost of a query doesn't depend on the triangle
+// density. Queries are thread-safe, the mesh must outlive the field.
+class DistanceField {
+public:
+  explicit DistanceField() = default;
+
+  // Only voxel columns for which `region(x, z)` returns true are filled,
+  // queries elsewhere see no geometry
+  explicit DistanceField(const std::vector<glm::vec3> &vertices,
+                         const std::vector<unsigned int> &indices,
+                         float voxel_size, float band,
+                         const std::function<bool(float, float)> &region);
+
+  // Lower bound of the distance from the point to the mesh (up to the band)
+  auto distance(const glm::vec3 &point) const -> float;
+
+  auto intersects(const geometry::Sphere &sphere) const -> bool;
+
+  // Conservative advancement: the sphere is moved by the free distance around
+  // it (at least a quarter of a voxel) until it comes close to the surface.
+  // There the contact is resolved against the nearest triangles of the
+  // surrounding voxels, which also give the normal. Same contract as
+  // geometry::BVH::sweep, contacts count only if the sphere moves towards the
+  // triangle.
+  auto sweep(const geometry::Sphere &sphere, const glm::vec3 &movement,
+             geometry::SweepIntersection &intersection) const -> bool;
+
+  auto brick_count() const -> std::size_t { return m_bricks.size(); }
+
+private:
+  static constexpr auto BRICK_SIZE = 8;
+  static constexpr auto BRICK_VOXELS = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+  static constexpr std::uint32_t NO_TRIANGLE = ~std::uint32_t{0};
+
+  struct Brick {
+    std::array<std::uint8_t, BRICK_VOXELS> distances;
+    std::array<std::uint32_t, BRICK_VOXELS> triangles;
+  };
+
+  const std::vector<glm::vec3> *m_vertices = nullptr;
+  const std::vector<unsigned int> *m_indices = nullptr;
+
+  float m_voxel_size = 1.0f;
+  float m_band = 0.0f;
+  float m_error = 0.0f; // Distance from a point to its voxel center
+
+  std::unordered_map<std::uint64_t, std::uint32_t> m_brick_index;
+  std::vector<Brick> m_bricks;
+
+  auto find_brick(int x, int y, int z) const -> const Brick *;
+  auto triangle(std::uint32_t index) const -> geometry::Triangle;
+
+  static auto brick_key(int x, int y, int z) -> std::uint64_t;
+  static auto voxel_offset(int x, int y, int z) -> int;
+};
+
+} // namespace geodata
@@ -15,20 +15,19 @@ static constexpr auto CELL_HEIGHT = 8;
 
 ExportBuffer::ExportBuffer()
     : m_blocks{MAP_WIDTH_BLOCKS * MAP_HEIGHT_BLOCKS},
-      m_columns{MAP_WIDTH_CELLS * MAP_HEIGHT_CELLS}, m_cells{MAP_WIDTH_CELLS *
-                                                             MAP_HEIGHT_CELLS *
-                                                             MAX_LAYERS} {}
+      m_columns{MAP_WIDTH_CELLS * MAP_HEIGHT_CELLS},
+      m_offsets(MAP_WIDTH_CELLS * MAP_HEIGHT_CELLS + 1) {}
 
 void ExportBuffer::reset(const Geodata &geodata) {
   std::fill(m_blocks.begin(), m_blocks.end(), Block{});
   std::fill(m_columns.begin(), m_columns.end(), Column{});
-  std::fill(m_cells.begin(), m_cells.end(), PackedCell{});
 
   // Sort cells by Z for correct order of the layers
   auto sorted_cells = geodata.cells;
   std::sort(sorted_cells.begin(), sorted_cells.end(),
             [](const auto &a, const auto &b) { return a.z < b.z; });
 
+  // Count layers of the columns
   for (const auto &cell : sorted_cells) {
     const auto column_index = cell.y + cell.x * MAP_WIDTH_CELLS;
     const auto block_index = cell.y / BLOCK_HEIGHT_CELLS +
@@ -40,11 +39,30 @@ void ExportBuffer::reset(const Geodata &geodata) {
     block.type = cell.type;
 
     column.layers++;
-    m_cells[column_index * MAX_LAYERS + column.layers - 1] = pack_cell(cell);
 
     ASSERT(column.layers < MAX_LAYERS - 1, "Geodata", // MAX_LAYERS - 1 is ok
            "Too many layers in column: " << cell.x << " " << cell.y);
   }
+
+  // Empty columns keep one zero cell, so the first layer can always be read
+  // and written
+  m_offsets[0] = 0;
+
+  for (std::size_t i = 0; i < m_columns.size(); ++i) {
+    const auto layers = std::max(m_columns[i].layers, std::uint8_t{1});
+    m_offsets[i + 1] = m_offsets[i] + layers;
+    m_columns[i].layers = 0;
+  }
+
+  m_cells.assign(m_offsets.back(), PackedCell{});
+
+  for (const auto &cell : sorted_cells) {
+    const auto column_index = cell.y + cell.x * MAP_WIDTH_CELLS;
+    auto &column = m_columns[column_index];
+
+    m_cells[m_offsets[column_index] + column.layers] = pack_cell(cell);
+    column.layers++;
+  }
 }
 
 auto ExportBuffer::convert_to_geodata() const -> Geodata {
@@ -93,16 +111,13 @@ auto ExportBuffer::block(int x, int y) const -> const Block & {
 auto ExportBuffer::column(int x, int y, int cx, int cy) const
     -> const Column & {
 
-  const auto column_index = (y * BLOCK_HEIGHT_CELLS) + cy +
-                            ((x * BLOCK_WIDTH_CELLS) + cx) * MAP_WIDTH_CELLS;
-  return m_columns[column_index];
+  return m_columns[column_index(x, y, cx, cy)];
 }
 
 auto ExportBuffer::cell(int x, int y, int cx, int cy, int layer) const -> Cell {
   const auto column_y = (y * BLOCK_HEIGHT_CELLS) + cy;
   const auto column_x = (x * BLOCK_WIDTH_CELLS) + cx;
-  const auto column_index = column_y + column_x * MAP_WIDTH_CELLS;
-  const auto cell_index = column_index * MAX_LAYERS + layer;
+  const auto cell_index = m_offsets[column_index(x, y, cx, cy)] + layer;
   const auto block_index = y + x * MAP_WIDTH_BLOCKS;
   return unpack_cell(m_cells[cell_index], m_blocks[block_index].type, column_x,
                      column_y);
@@ -114,12 +129,15 @@ void ExportBuffer::set_block_type(int x, int y, BlockType type) {
 }
 
 void ExportBuffer::set_block_height(int x, int y, std::int16_t height) {
-  const auto column_index =
-      (y * BLOCK_HEIGHT_CELLS) + (x * BLOCK_WIDTH_CELLS) * MAP_WIDTH_CELLS;
-  const auto cell_index = column_index * MAX_LAYERS;
+  const auto cell_index = m_offsets[column_index(x, y, 0, 0)];
   m_cells[cell_index].height = round_height(height);
 }
 
+auto ExportBuffer::column_index(int x, int y, int cx, int cy) const -> int {
+  return (y * BLOCK_HEIGHT_CELLS) + cy +
+         ((x * BLOCK_WIDTH_CELLS) + cx) * MAP_WIDTH_CELLS;
+}
+
 auto ExportBuffer::pack_cell(const Cell &cell) const -> PackedCell {
   PackedCell packed_cell{};
   packed_cell.height = round_height(cell.z);
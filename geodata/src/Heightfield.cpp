@@ -0,0 +1,42 @@
+#include "pch.h"
+
+#include "Heightfield.h"
+
+namespace geodata {
+
+Heightfield::Heightfield(const rcHeightfield &hf,
+                         std::pmr::memory_resource *resource)
+    : width{hf.width}, height{hf.height},
+      column_offsets(static_cast<std::size_t>(hf.width) * hf.height + 1,
+                     resource),
+      smin{resource}, smax{resource}, areas{resource} {
+
+  const auto column_count = width * height;
+
+  for (auto i = 0; i < column_count; ++i) {
+    auto span_count = 0u;
+
+    for (const auto *span = hf.spans[i]; span != nullptr; span = span->next) {
+      span_count++;
+    }
+
+    column_offsets[i + 1] = column_offsets[i] + span_count;
+  }
+
+  smin.resize(column_offsets.back());
+  smax.resize(column_offsets.back());
+  areas.resize(column_offsets.back());
+
+  for (auto i = 0; i < column_count; ++i) {
+    auto index = column_offsets[i];
+
+    for (const auto *span = hf.spans[i]; span != nullptr; span = span->next) {
+      smin[index] = static_cast<std::uint16_t>(span->smin);
+      smax[index] = static_cast<std::uint16_t>(span->smax);
+      areas[index] = static_cast<std::uint8_t>(span->area);
+      index++;
+    }
+  }
+}
+
+} // namespace geodata
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Recast.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace geodata {
+
+// Compact copy of a Recast heightfield with the structure of arrays layout.
+// Spans of a column are contiguous (bottom to top), columns are stored row by
+// row, so neighbour columns are read without pointer chasing.
+struct Heightfield {
+  int width;
+  int height;
+
+  // Spans of a column: [column_offsets[column], column_offsets[column + 1])
+  std::pmr::vector<std::uint32_t> column_offsets;
+
+  std::pmr::vector<std::uint16_t> smin;
+  std::pmr::vector<std::uint16_t> smax;
+  std::pmr::vector<std::uint8_t> areas;
+
+  explicit Heightfield(const rcHeightfield &hf,
+                       std::pmr::memory_resource *resource =
+                           std::pmr::get_default_resource());
+
+  auto column_begin(int column) const -> std::uint32_t {
+    return column_offsets[column];
+  }
+
+  auto column_end(int column) const -> std::uint32_t {
+    return column_offsets[column + 1];
+  }
+
+  auto span_count() const -> std::size_t { return areas.size(); }
+
+  // Bottom of the next span in the column, open spans reach the max height
+  auto top(int column, std::uint32_t span) const -> int {
+    return span + 1 < column_end(column) ? smin[span + 1] : RC_SPAN_MAX_HEIGHT;
+  }
+};
+
+} // namespace geodata
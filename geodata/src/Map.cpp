@@ -15,6 +15,11 @@ auto swap_y_with_z(const geometry::Box &box) -> geometry::Box {
 Map::Map(const std::string &name, const geometry::Box &bounding_box)
     : m_name{name}, m_bounding_box{swap_y_with_z(bounding_box)} {}
 
+Map::Map(const std::string &name, const geometry::Box &bounding_box,
+         std::vector<glm::vec3> vertices, std::vector<unsigned int> indices)
+    : m_name{name}, m_bounding_box{swap_y_with_z(bounding_box)},
+      m_vertices{std::move(vertices)}, m_indices{std::move(indices)} {}
+
 Map::Map(Map &&other) noexcept
     : m_name{std::move(other.m_name)}, m_bounding_box{std::move(
                                            other.m_bounding_box)},
@@ -75,6 +80,79 @@ void Map::add(const Entity &entity) {
   }
 }
 
+// Interleaves bits of two 16-bit values
+static auto morton_code(std::uint32_t x, std::uint32_t y) -> std::uint32_t {
+  const auto spread = [](std::uint32_t value) {
+    value = (value | value << 8) & 0x00ff00ff;
+    value = (value | value << 4) & 0x0f0f0f0f;
+    value = (value | value << 2) & 0x33333333;
+    value = (value | value << 1) & 0x55555555;
+    return value;
+  };
+
+  return spread(x) | spread(y) << 1;
+}
+
+void Map::sort_triangles() {
+  const auto triangle_count = m_indices.size() / 3;
+
+  if (triangle_count == 0) {
+    return;
+  }
+
+  std::vector<glm::vec3> centroids(triangle_count);
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+  for (std::size_t i = 0; i < triangle_count; ++i) {
+    centroids[i] = (m_vertices[m_indices[i * 3 + 0]] +
+                    m_vertices[m_indices[i * 3 + 1]] +
+                    m_vertices[m_indices[i * 3 + 2]]) /
+                   3.0f;
+    min = glm::min(min, centroids[i]);
+    max = glm::max(max, centroids[i]);
+  }
+
+  // Quantize centroids to 16 bits per axis, ties keep the original order
+  const auto extent = glm::max(max - min, glm::vec3{1.0f});
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> keys(triangle_count);
+
+  for (std::size_t i = 0; i < triangle_count; ++i) {
+    const auto x = (centroids[i].x - min.x) / extent.x * 65535.0f;
+    const auto z = (centroids[i].z - min.z) / extent.z * 65535.0f;
+
+    keys[i] = {morton_code(static_cast<std::uint32_t>(x),
+                           static_cast<std::uint32_t>(z)),
+               static_cast<std::uint32_t>(i)};
+  }
+
+  std::sort(keys.begin(), keys.end());
+
+  static constexpr auto unassigned = std::numeric_limits<unsigned int>::max();
+
+  std::vector<unsigned int> remap(m_vertices.size(), unassigned);
+  std::vector<glm::vec3> vertices;
+  std::vector<unsigned int> indices;
+  vertices.reserve(m_vertices.size());
+  indices.reserve(m_indices.size());
+
+  for (const auto &[key, triangle] : keys) {
+    for (auto corner = 0; corner < 3; ++corner) {
+      const auto vertex = m_indices[triangle * 3 + corner];
+
+      if (remap[vertex] == unassigned) {
+        remap[vertex] = static_cast<unsigned int>(vertices.size());
+        vertices.push_back(m_vertices[vertex]);
+      }
+
+      indices.push_back(remap[vertex]);
+    }
+  }
+
+  m_vertices.swap(vertices);
+  m_indices.swap(indices);
+}
+
 auto Map::name() const -> const std::string & { return m_name; }
 
 auto Map::bounding_box() const -> geometry::Box {
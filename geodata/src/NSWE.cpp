@@ -2,19 +2,28 @@
 
 #include "NSWE.h"
 
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <optional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NSWE_SSE2
+#endif
+
 #define ENABLE_SIMPLE_NSWE_CALCULATION
 
+#if defined(NSWE_DISTANCE_FIELD) && !defined(NSWE_SWEPT_COLLISION)
+#error "Distance field collision requires NSWE_SWEPT_COLLISION"
+#endif
+
 namespace geodata {
 
 void mark_walkable_triangles(float walkable_angle, const float *vertices,
                              const int *triangles, std::size_t triangle_count,
                              unsigned char *areas);
 
-auto triangles_at_columns(const rcHeightfield &hf, const Map &map,
-                          const std::vector<std::vector<int>> &triangle_index,
-                          int x, int y, int radius = 0)
-    -> std::vector<geometry::Triangle>;
-
 inline auto allow_direction(int area, int direction) -> int {
   return area | 1 << (direction + 2);
 }
@@ -31,38 +40,167 @@ inline auto direction_forbidden(int area, int direction) -> bool {
   return (area >> 2 & (1 << direction)) == 0;
 }
 
+// Heightfield rows rasterized by a job
+static constexpr auto RASTERIZATION_TILE_ROWS = 64;
+
+// Distance field voxels per heightfield cell (horizontally)
+static constexpr auto DISTANCE_FIELD_VOXELS_PER_CELL = 4;
+
+static constexpr std::uint8_t COLLISION_UNTESTED = 0;
+static constexpr std::uint8_t COLLISION_ALLOWED = 1;
+static constexpr std::uint8_t COLLISION_BLOCKED = 2;
+
 inline auto vertical_slope(const glm::vec3 &vector) -> float {
   // TODO: Vector can be already normalized
   return glm::dot(glm::normalize(vector), {0.0f, 1.0f, 0.0f});
 }
 
-template <typename T>
-auto fill_vector(std::vector<std::vector<T>> &vector, int size) {
-  vector.reserve(size);
+#ifdef NSWE_SSE2
+static constexpr auto SIMPLE_NSWE_LANES = 8;
+
+// Columns [column, column + SIMPLE_NSWE_LANES) and their neighbour columns
+// hold a span each. Spans of such columns are consecutive, so lanes are loaded
+// right from the heightfield arrays.
+static auto single_layer_run(const Heightfield &hf, int column) -> bool {
+  const auto single_layer = [&hf](int first, int count) {
+    for (auto i = first; i < first + count; ++i) {
+      if (hf.column_end(i) - hf.column_begin(i) != 1) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  return single_layer(column - 1, SIMPLE_NSWE_LANES + 2) &&
+         single_layer(column - hf.width, SIMPLE_NSWE_LANES) &&
+         single_layer(column + hf.width, SIMPLE_NSWE_LANES);
+}
+
+// Unsigned 16-bit a < b
+static auto less_epu16(__m128i a, __m128i b) -> __m128i {
+  const auto bias = _mm_set1_epi16(static_cast<short>(0x8000));
+  return _mm_cmplt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+// Simple NSWE calculation of a single-layer run (see single_layer_run), same
+// as the scalar version with heights in unsigned 16-bit lanes: single spans
+// are open to the top, so only bottoms are compared
+static void calculate_simple_nswe_sse2(const Heightfield &hf, int column,
+                                       int actor_height_cells,
+                                       int min_walkable_climb_cells,
+                                       int max_walkable_climb_cells,
+                                       std::uint8_t *areas) {
+
+  const auto zero = _mm_setzero_si128();
+  const auto all = _mm_set1_epi16(-1);
+
+  const auto load_heights = [&hf](std::uint32_t span) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(&hf.smax[span]));
+  };
+
+  const auto load_areas = [&hf, zero](std::uint32_t span) {
+    return _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&hf.areas[span])),
+        zero);
+  };
 
-  for (auto i = 0; i < size; ++i) {
-    auto inner_vector = std::vector<T>();
-    vector.push_back(std::move(inner_vector));
+  const auto area_mask = _mm_set1_epi16(0x3);
+  const auto steep_limit = _mm_set1_epi16(RC_STEEP_AREA + 1);
+
+  // Free height above both spans: RC_SPAN_MAX_HEIGHT - max(bottoms)
+  const auto height_limit = _mm_set1_epi16(static_cast<short>(
+      std::max(RC_SPAN_MAX_HEIGHT - actor_height_cells, 0)));
+  const auto min_climb =
+      _mm_set1_epi16(static_cast<short>(min_walkable_climb_cells));
+  const auto max_climb =
+      _mm_set1_epi16(static_cast<short>(max_walkable_climb_cells));
+
+  const auto span = hf.column_begin(column);
+  const auto bottom = load_heights(span);
+  const auto original_area = load_areas(span);
+  const auto area = _mm_and_si128(original_area, area_mask);
+
+  const auto not_null = _mm_andnot_si128(_mm_cmpeq_epi16(area, zero), all);
+  const auto steep = _mm_cmplt_epi16(area, steep_limit);
+  const auto high_enough = less_epu16(bottom, height_limit);
+
+  auto directions = zero;
+  auto complex = zero;
+
+  for (auto direction = 0; direction < 4; ++direction) {
+    const auto side_column = column + rcGetDirOffsetX(direction) +
+                             rcGetDirOffsetY(direction) * hf.width;
+    const auto side_span = hf.column_begin(side_column);
+
+    const auto neighbour_bottom = load_heights(side_span);
+    const auto neighbour_area =
+        _mm_and_si128(load_areas(side_span), area_mask);
+
+    const auto passable =
+        _mm_and_si128(high_enough, less_epu16(neighbour_bottom, height_limit));
+    const auto any_steep =
+        _mm_or_si128(steep, _mm_cmplt_epi16(neighbour_area, steep_limit));
+
+    // diff <= climb, saturated sum can't wrap
+    const auto min_climb_allowed = _mm_andnot_si128(
+        less_epu16(_mm_adds_epu16(bottom, min_climb), neighbour_bottom), all);
+    const auto max_climb_allowed = _mm_andnot_si128(
+        less_epu16(_mm_adds_epu16(bottom, max_climb), neighbour_bottom), all);
+
+    const auto allowed = _mm_and_si128(
+        passable, _mm_or_si128(_mm_and_si128(any_steep, min_climb_allowed),
+                               _mm_andnot_si128(any_steep, max_climb_allowed)));
+
+    // |diff| in [min_climb, max_climb]
+    const auto difference =
+        _mm_or_si128(_mm_subs_epu16(neighbour_bottom, bottom),
+                     _mm_subs_epu16(bottom, neighbour_bottom));
+    const auto in_range =
+        _mm_andnot_si128(_mm_or_si128(less_epu16(difference, min_climb),
+                                      less_epu16(max_climb, difference)),
+                         all);
+
+    complex = _mm_or_si128(
+        complex,
+        _mm_andnot_si128(any_steep, _mm_and_si128(passable, in_range)));
+    directions = _mm_or_si128(
+        directions,
+        _mm_and_si128(allowed, _mm_set1_epi16(
+                                   static_cast<short>(1 << (direction + 2)))));
   }
+
+  // RC_COMPLEX_AREA is all area bits, so it's just ORed
+  const auto changes = _mm_and_si128(
+      not_null,
+      _mm_or_si128(directions, _mm_and_si128(complex, _mm_set1_epi16(
+                                                          RC_COMPLEX_AREA))));
+  const auto result = _mm_or_si128(original_area, changes);
+
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(&areas[span]),
+                   _mm_packus_epi16(result, zero));
 }
+#endif
 
 NSWE::NSWE(const Map &map, float actor_height, float actor_radius,
            float max_walkable_angle, float min_walkable_climb,
-           float max_walkable_climb, float cell_size, float cell_height)
+           float max_walkable_climb, float cell_size, float cell_height,
+           utils::JobPool &job_pool, utils::Arena &arena)
     : m_map{map}, m_actor_height{actor_height}, m_actor_radius{actor_radius},
       m_max_walkable_angle_radians{std::cos(glm::radians(max_walkable_angle))},
       m_min_walkable_climb{min_walkable_climb},
       m_max_walkable_climb{max_walkable_climb}, m_cell_size{cell_size},
-      m_cell_height{cell_height}, m_hf{rcAllocHeightfield()} {
-
-  utils::Log(utils::LOG_INFO, "Geodata")
-      << "Building intial heightfield" << std::endl;
-  build_filtered_heightfield();
-}
-
-NSWE::~NSWE() { rcFreeHeightField(m_hf); }
+      m_cell_height{cell_height},
+      m_triangles_fetch_radius{
+          static_cast<int>(std::ceil(actor_radius * 2.0f / cell_size))},
+      m_job_pool{job_pool}, m_arena{arena},
+#ifdef NSWE_SWEPT_COLLISION
+      m_bvh{map.vertices(), map.indices()},
+#endif
+      m_triangle_index{&arena},
+      m_hf{build_filtered_heightfield()}, m_triangle_cache{&arena} {}
 
-auto NSWE::calculate_nswe() -> const rcHeightfield & {
+auto NSWE::calculate_nswe() -> const Heightfield & {
 
 #ifdef ENABLE_SIMPLE_NSWE_CALCULATION
   utils::Log(utils::LOG_INFO, "Geodata")
@@ -70,13 +208,24 @@ auto NSWE::calculate_nswe() -> const rcHeightfield & {
   calculate_simple_nswe();
 #endif
 
+#ifndef NSWE_SWEPT_COLLISION
+  build_triangle_cache();
+#endif
+
+#ifdef NSWE_DISTANCE_FIELD
+  build_distance_field();
+#endif
+
   utils::Log(utils::LOG_INFO, "Geodata") << "Collision detection" << std::endl;
   calculate_complex_nswe();
 
-  return *m_hf;
+  return m_hf;
 }
 
-void NSWE::build_filtered_heightfield() {
+auto NSWE::build_filtered_heightfield() -> Heightfield {
+  utils::Log(utils::LOG_INFO, "Geodata")
+      << "Building intial heightfield" << std::endl;
+
   const auto *bb_min = glm::value_ptr(m_map.internal_bounding_box().min());
   const auto *bb_max = glm::value_ptr(m_map.internal_bounding_box().max());
 
@@ -87,7 +236,8 @@ void NSWE::build_filtered_heightfield() {
 
   // Create heightfield
   rcContext context{};
-  rcCreateHeightfield(&context, *m_hf, width, height, bb_min, bb_max,
+  auto *hf = rcAllocHeightfield();
+  rcCreateHeightfield(&context, *hf, width, height, bb_min, bb_max,
                       m_cell_size, m_cell_height);
 
   // Prepare geometry data
@@ -96,19 +246,168 @@ void NSWE::build_filtered_heightfield() {
   const auto *triangles = reinterpret_cast<const int *>(m_map.indices().data());
   const auto triangle_count = m_map.indices().size() / 3;
 
-  // Rasterize triangles
-  fill_vector(m_triangle_index, width * height);
-  fill_vector(m_triangle_cache, width * height);
-
-  std::vector<unsigned char> areas(triangle_count);
+  // Rasterize triangles and filter too short spans
+  std::pmr::vector<unsigned char> areas(triangle_count, &m_arena);
   mark_walkable_triangles(vertices, triangles, triangle_count, &areas.front());
-  rcRasterizeTriangles(&context, vertices, vertex_count, triangles,
-                       &areas.front(), triangle_count, *m_hf,
-                       &m_triangle_index.front());
 
-  // Filter too short spans
-  rcFilterWalkableLowHeightSpans(
-      &context, static_cast<int>(m_actor_height / m_cell_height), *m_hf);
+#ifdef NSWE_SWEPT_COLLISION
+  rasterize_tiles(*hf, vertices, static_cast<int>(vertex_count), triangles,
+                  areas, nullptr);
+#else
+  std::pmr::vector<rcTriangleColumn> triangle_columns{&m_arena};
+  rasterize_tiles(*hf, vertices, static_cast<int>(vertex_count), triangles,
+                  areas, &triangle_columns);
+  build_triangle_index(triangle_columns, width * height);
+#endif
+
+  // Later passes work on the compact copy
+  Heightfield heightfield{*hf, &m_arena};
+  rcFreeHeightField(hf);
+
+  return heightfield;
+}
+
+// Moves spans of the tile into the rows of the heightfield starting at
+// first_row, pools of the tile go along with them
+static void stitch_tile(rcHeightfield &hf, rcHeightfield &tile, int first_row) {
+
+  auto *spans = hf.spans + first_row * hf.width;
+
+  for (auto column = 0; column < tile.width * tile.height; ++column) {
+    spans[column] = tile.spans[column];
+    tile.spans[column] = nullptr;
+  }
+
+  if (tile.pools == nullptr) {
+    return;
+  }
+
+  auto *last_pool = tile.pools;
+
+  while (last_pool->next != nullptr) {
+    last_pool = last_pool->next;
+  }
+
+  last_pool->next = hf.pools;
+  hf.pools = tile.pools;
+  tile.pools = nullptr;
+  tile.freelist = nullptr;
+}
+
+// Tiles are bands of rows. A tile rasterizes triangles overlapping its rows
+// (in map order) into a heightfield holding only these rows. Recast clips the
+// triangles in the coordinates of the map grid from its first row on, so every
+// column sees the same triangles in the same order and with the same
+// arithmetic as in a single pass. The low-height filter only looks at a
+// column, so it runs per tile too.
+void NSWE::rasterize_tiles(
+    rcHeightfield &hf, const float *vertices, int vertex_count,
+    const int *triangles, std::span<const unsigned char> areas,
+    std::pmr::vector<rcTriangleColumn> *triangle_columns) {
+
+  const auto tile_count =
+      (hf.height + RASTERIZATION_TILE_ROWS - 1) / RASTERIZATION_TILE_ROWS;
+  const auto triangle_count = static_cast<int>(areas.size());
+  const auto walkable_height = static_cast<int>(m_actor_height / m_cell_height);
+
+  // Bin triangles by rows of their footprint, with a row of margin for
+  // rounding
+  std::vector<std::vector<int>> tile_triangles(tile_count);
+  const auto ics = 1.0f / hf.cs;
+
+  for (auto i = 0; i < triangle_count; ++i) {
+    auto min_z = std::numeric_limits<float>::max();
+    auto max_z = std::numeric_limits<float>::lowest();
+
+    for (auto j = 0; j < 3; ++j) {
+      const auto z = vertices[triangles[i * 3 + j] * 3 + 2];
+      min_z = std::min(min_z, z);
+      max_z = std::max(max_z, z);
+    }
+
+    const auto first_row =
+        std::clamp(static_cast<int>((min_z - hf.bmin[2]) * ics) - 1, 0,
+                   hf.height - 1);
+    const auto last_row =
+        std::clamp(static_cast<int>((max_z - hf.bmin[2]) * ics) + 1, 0,
+                   hf.height - 1);
+
+    for (auto tile = first_row / RASTERIZATION_TILE_ROWS;
+         tile <= last_row / RASTERIZATION_TILE_ROWS; ++tile) {
+
+      tile_triangles[tile].push_back(i);
+    }
+  }
+
+  std::vector<std::vector<rcTriangleColumn>> tile_columns(tile_count);
+  std::mutex stitch_mutex;
+
+  for (auto tile = 0; tile < tile_count; ++tile) {
+    m_job_pool.submit([&, tile](std::size_t) {
+      // Tile heightfields are freed right after stitching, their column
+      // arrays are recycled by the arena
+      const utils::Arena::Scope arena_scope{m_arena};
+
+      const auto &tile_triangle_indices = tile_triangles[tile];
+      const auto first_row = tile * RASTERIZATION_TILE_ROWS;
+      const auto last_row =
+          std::min(first_row + RASTERIZATION_TILE_ROWS, hf.height);
+
+      std::vector<int> tile_indices;
+      std::vector<unsigned char> tile_areas;
+      tile_indices.reserve(tile_triangle_indices.size() * 3);
+      tile_areas.reserve(tile_triangle_indices.size());
+
+      for (const auto triangle : tile_triangle_indices) {
+        tile_indices.insert(tile_indices.end(), triangles + triangle * 3,
+                            triangles + triangle * 3 + 3);
+        tile_areas.push_back(areas[triangle]);
+      }
+
+      rcContext context{};
+      // Bounds of the map grid, Recast skips rows before first_row
+      auto *tile_hf = rcAllocHeightfield();
+      rcCreateHeightfield(&context, *tile_hf, hf.width, last_row - first_row,
+                          hf.bmin, hf.bmax, hf.cs, hf.ch);
+
+      std::vector<rcTriangleColumn> columns;
+      rcRasterizeTriangles(
+          &context, vertices, vertex_count, tile_indices.data(),
+          tile_areas.data(), static_cast<int>(tile_triangle_indices.size()),
+          *tile_hf, first_row,
+          triangle_columns != nullptr ? &columns : nullptr);
+      rcFilterWalkableLowHeightSpans(&context, walkable_height, *tile_hf);
+
+      // Columns are recorded in map coordinates, only triangle indices are
+      // of the tile
+      for (const auto &column : columns) {
+        tile_columns[tile].push_back({
+            column.column,
+            tile_triangle_indices[column.triangle],
+            column.smin,
+            column.smax,
+        });
+      }
+
+      {
+        std::lock_guard lock{stitch_mutex};
+        stitch_tile(hf, *tile_hf, first_row);
+      }
+
+      rcFreeHeightField(tile_hf);
+    });
+  }
+
+  m_job_pool.wait();
+
+  // Tiles own disjoint columns, so per-column order is the one of a single
+  // pass
+  if (triangle_columns != nullptr) {
+    for (const auto &columns : tile_columns) {
+      triangle_columns->insert(triangle_columns->end(), columns.begin(),
+                               columns.end());
+    }
+  }
 }
 
 void NSWE::mark_walkable_triangles(const float *vertices, const int *triangles,
@@ -134,7 +433,217 @@ void NSWE::mark_walkable_triangles(const float *vertices, const int *triangles,
   }
 }
 
+void NSWE::build_triangle_index(
+    std::span<const rcTriangleColumn> triangle_columns, int column_count) {
+
+  auto &offsets = m_triangle_index.offsets;
+  auto &values = m_triangle_index.values;
+
+  offsets.assign(column_count + 1, 0);
+
+  for (const auto &triangle_column : triangle_columns) {
+    offsets[triangle_column.column + 1]++;
+  }
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  values.resize(offsets.back());
+
+  // Triangles are recorded in ascending order, so lists stay sorted
+  std::vector<std::uint32_t> positions(offsets.begin(), offsets.end() - 1);
+
+  for (const auto &triangle_column : triangle_columns) {
+    values[positions[triangle_column.column]++] = {
+        triangle_column.triangle,
+        triangle_column.smin,
+        triangle_column.smax,
+    };
+  }
+}
+
+void NSWE::build_triangle_cache() {
+  const auto column_count = m_hf.width * m_hf.height;
+
+  auto &offsets = m_triangle_cache.offsets;
+  auto &values = m_triangle_cache.values;
+
+  offsets.assign(column_count + 1, 0);
+
+  // Scratch list per worker
+  std::vector<std::vector<ColumnTriangle>> triangles(
+      m_job_pool.thread_count());
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    m_job_pool.submit([this, y, &offsets, &triangles](std::size_t worker) {
+      for (auto x = 0; x < m_hf.width; ++x) {
+        if (has_complex_spans(x, y)) {
+          collect_column_triangles(x, y, triangles[worker]);
+          offsets[x + y * m_hf.width + 1] =
+              static_cast<std::uint32_t>(triangles[worker].size());
+        }
+      }
+    });
+  }
+
+  m_job_pool.wait();
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  values.resize(offsets.back());
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    m_job_pool.submit(
+        [this, y, &offsets, &values, &triangles](std::size_t worker) {
+          for (auto x = 0; x < m_hf.width; ++x) {
+            if (has_complex_spans(x, y)) {
+              collect_column_triangles(x, y, triangles[worker]);
+              std::copy(triangles[worker].begin(), triangles[worker].end(),
+                        values.begin() + offsets[x + y * m_hf.width]);
+            }
+          }
+        });
+  }
+
+  m_job_pool.wait();
+}
+
+void NSWE::collect_column_triangles(
+    int x, int y, std::vector<ColumnTriangle> &triangles) const {
+
+  const auto radius = m_triangles_fetch_radius;
+
+  triangles.clear();
+
+  for (auto dy = y - radius; dy < y + radius + 1; ++dy) {
+    for (auto dx = x - radius; dx < x + radius + 1; ++dx) {
+      if (dx < 0 || dy < 0 || dx >= m_hf.width || dy >= m_hf.height) {
+        continue;
+      }
+
+      const auto indices = m_triangle_index.at(dx + dy * m_hf.width);
+      triangles.insert(triangles.end(), indices.begin(), indices.end());
+    }
+  }
+
+  std::sort(triangles.begin(), triangles.end(),
+            [](const ColumnTriangle &a, const ColumnTriangle &b) {
+              return a.triangle < b.triangle;
+            });
+
+  // Merge entries of a triangle from different columns
+  auto last = triangles.begin();
+
+  for (auto it = triangles.begin(); it != triangles.end(); ++it) {
+    if (it == last) {
+      continue;
+    }
+
+    if (it->triangle == last->triangle) {
+      last->smin = std::min(last->smin, it->smin);
+      last->smax = std::max(last->smax, it->smax);
+    } else {
+      *++last = *it;
+    }
+  }
+
+  if (!triangles.empty()) {
+    triangles.erase(last + 1, triangles.end());
+  }
+}
+
+auto NSWE::has_complex_spans(int x, int y) const -> bool {
+  const auto column = x + y * m_hf.width;
+
+#ifdef ENABLE_SIMPLE_NSWE_CALCULATION
+  for (auto span = m_hf.column_begin(column); span < m_hf.column_end(column);
+       ++span) {
+
+    if (unpack_area(m_hf.areas[span]) == RC_COMPLEX_AREA) {
+      return true;
+    }
+  }
+
+  return false;
+#else
+  return m_hf.column_begin(column) < m_hf.column_end(column);
+#endif
+}
+
+#ifdef NSWE_DISTANCE_FIELD
+// Field is filled around the columns with complex spans only, with the same
+// margin as the triangle cache plus a column for the slide distance
+void NSWE::build_distance_field() {
+  utils::Log(utils::LOG_INFO, "Geodata")
+      << "Building distance field" << std::endl;
+
+  const auto margin = m_triangles_fetch_radius + 1;
+  std::vector<bool> region(static_cast<std::size_t>(m_hf.width) *
+                           m_hf.height);
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    for (auto x = 0; x < m_hf.width; ++x) {
+      if (!has_complex_spans(x, y)) {
+        continue;
+      }
+
+      for (auto ry = std::max(0, y - margin);
+           ry <= std::min(m_hf.height - 1, y + margin); ++ry) {
+
+        for (auto rx = std::max(0, x - margin);
+             rx <= std::min(m_hf.width - 1, x + margin); ++rx) {
+
+          region[rx + ry * m_hf.width] = true;
+        }
+      }
+    }
+  }
+
+  const auto &origin = m_map.internal_bounding_box().min();
+  const auto voxel_size = m_cell_size / DISTANCE_FIELD_VOXELS_PER_CELL;
+
+  m_distance_field = DistanceField{
+      m_map.vertices(),
+      m_map.indices(),
+      voxel_size,
+      m_actor_radius + voxel_size * 4.0f,
+      [this, &region, &origin](float x, float z) {
+        const auto column_x =
+            static_cast<int>(std::floor((x - origin.x) / m_cell_size));
+        const auto column_y =
+            static_cast<int>(std::floor((z - origin.z) / m_cell_size));
+
+        return column_x >= 0 && column_y >= 0 && column_x < m_hf.width &&
+               column_y < m_hf.height &&
+               region[column_x + column_y * m_hf.width];
+      },
+  };
+
+  utils::Log(utils::LOG_DEBUG, "Geodata")
+      << "Distance field bricks: " << m_distance_field.brick_count()
+      << std::endl;
+}
+#endif
+
 void NSWE::calculate_simple_nswe() {
+  // Columns read areas of neighbour columns, so new areas are written aside
+  // and replace the old ones after all columns are processed
+  std::pmr::vector<std::uint8_t> areas(m_hf.span_count(), &m_arena);
+  std::atomic<int> completed_rows = 0;
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    m_job_pool.submit([this, y, &areas, &completed_rows](std::size_t) {
+      calculate_simple_nswe_row(y, areas.data());
+      print_progress(++completed_rows);
+    });
+  }
+
+  m_job_pool.wait();
+
+  m_hf.areas.swap(areas);
+}
+
+void NSWE::calculate_simple_nswe_row(int y, std::uint8_t *areas) const {
+  auto x = 0;
+
+#ifdef NSWE_SSE2
   const auto actor_height_cells =
       static_cast<int>(m_actor_height / m_cell_height);
   const auto min_walkable_climb_cells =
@@ -142,143 +651,493 @@ void NSWE::calculate_simple_nswe() {
   const auto max_walkable_climb_cells =
       static_cast<int>(m_max_walkable_climb / m_cell_height);
 
-  const auto max_height = 0xffff;
+  // Outdoor terrain is mostly single-layer, runs of such columns away from
+  // map edges go through the vector version
+  const auto vectorizable =
+      y > 0 && y < m_hf.height - 1 && actor_height_cells >= 0 &&
+      min_walkable_climb_cells >= 0 &&
+      max_walkable_climb_cells <= RC_SPAN_MAX_HEIGHT &&
+      min_walkable_climb_cells <= max_walkable_climb_cells;
+
+  if (vectorizable) {
+    x = 1;
+
+    while (x + SIMPLE_NSWE_LANES < m_hf.width) {
+      const auto column = x + y * m_hf.width;
+
+      if (single_layer_run(m_hf, column)) {
+        calculate_simple_nswe_sse2(m_hf, column, actor_height_cells,
+                                   min_walkable_climb_cells,
+                                   max_walkable_climb_cells, areas);
+        x += SIMPLE_NSWE_LANES;
+      } else {
+        calculate_simple_nswe(x, y, areas);
+        x++;
+      }
+    }
 
-  for (auto y = 0; y < m_hf->height; ++y) {
-    for (auto x = 0; x < m_hf->width; ++x) {
-      print_progress(x, y);
+    calculate_simple_nswe(0, y, areas);
+  }
+#endif
 
-      for (auto *span = m_hf->spans[x + y * m_hf->width]; span != nullptr;
-           span = span->next) {
+  for (; x < m_hf.width; ++x) {
+    calculate_simple_nswe(x, y, areas);
+  }
+}
 
-        const auto area = unpack_area(span->area);
+void NSWE::calculate_simple_nswe(int x, int y, std::uint8_t *areas) const {
+  const auto actor_height_cells =
+      static_cast<int>(m_actor_height / m_cell_height);
+  const auto min_walkable_climb_cells =
+      static_cast<int>(m_min_walkable_climb / m_cell_height);
+  const auto max_walkable_climb_cells =
+      static_cast<int>(m_max_walkable_climb / m_cell_height);
 
-        if (area == RC_NULL_AREA) {
-          continue;
-        }
+  const auto column = x + y * m_hf.width;
 
-        const auto bottom = static_cast<int>(span->smax);
-        const auto top = span->next != nullptr
-                             ? static_cast<int>(span->next->smin)
-                             : max_height;
+  for (auto span = m_hf.column_begin(column); span < m_hf.column_end(column);
+       ++span) {
 
-        for (auto direction = 0; direction < 4; ++direction) {
-          const auto side_x = x + rcGetDirOffsetX(direction);
-          const auto side_y = y + rcGetDirOffsetY(direction);
+    auto new_area = static_cast<int>(m_hf.areas[span]);
+    const auto area = unpack_area(new_area);
 
-          // Allow moving outside of the map
-          if (side_x < 0 || side_y < 0 || side_x >= m_hf->width ||
-              side_y >= m_hf->height) {
+    if (area == RC_NULL_AREA) {
+      areas[span] = static_cast<std::uint8_t>(new_area);
+      continue;
+    }
 
-            span->area = allow_direction(span->area, direction);
-            continue;
-          }
+    const auto bottom = static_cast<int>(m_hf.smax[span]);
+    const auto top = m_hf.top(column, span);
 
-          auto direction_allowed = false;
+    for (auto direction = 0; direction < 4; ++direction) {
+      const auto side_x = x + rcGetDirOffsetX(direction);
+      const auto side_y = y + rcGetDirOffsetY(direction);
 
-          for (auto *neighbour = m_hf->spans[side_x + side_y * m_hf->width];
-               neighbour != nullptr; neighbour = neighbour->next) {
+      // Allow moving outside of the map
+      if (side_x < 0 || side_y < 0 || side_x >= m_hf.width ||
+          side_y >= m_hf.height) {
 
-            const auto neighbour_bottom = static_cast<int>(neighbour->smax);
-            const auto neighbour_top =
-                neighbour->next != nullptr
-                    ? static_cast<int>(neighbour->next->smin)
-                    : max_height;
+        new_area = allow_direction(new_area, direction);
+        continue;
+      }
+
+      auto direction_allowed = false;
+
+      const auto side_column = side_x + side_y * m_hf.width;
 
-            const auto height = std::min(top, neighbour_top) -
-                                std::max(bottom, neighbour_bottom);
-            const auto diff = neighbour_bottom - bottom;
+      for (auto neighbour = m_hf.column_begin(side_column);
+           neighbour < m_hf.column_end(side_column); ++neighbour) {
 
-            if (height > actor_height_cells) {
-              const auto neighbour_area = unpack_area(neighbour->area);
+        const auto neighbour_bottom = static_cast<int>(m_hf.smax[neighbour]);
+        const auto neighbour_top = m_hf.top(side_column, neighbour);
 
-              if (area <= RC_STEEP_AREA || neighbour_area <= RC_STEEP_AREA) {
-                // Forbid going up on steep surfaces
-                direction_allowed = diff <= min_walkable_climb_cells;
-              } else {
-                direction_allowed = diff <= max_walkable_climb_cells;
+        const auto height =
+            std::min(top, neighbour_top) - std::max(bottom, neighbour_bottom);
+        const auto diff = neighbour_bottom - bottom;
 
-                // Mark complex areas for further sphere-to-mesh collision
-                // detection
-                if (std::abs(diff) >= min_walkable_climb_cells &&
-                    std::abs(diff) <= max_walkable_climb_cells) {
+        if (height > actor_height_cells) {
+          const auto neighbour_area = unpack_area(m_hf.areas[neighbour]);
 
-                  span->area = change_area(span->area, RC_COMPLEX_AREA);
-                }
-              }
+          if (area <= RC_STEEP_AREA || neighbour_area <= RC_STEEP_AREA) {
+            // Forbid going up on steep surfaces
+            direction_allowed = diff <= min_walkable_climb_cells;
+          } else {
+            direction_allowed = diff <= max_walkable_climb_cells;
+
+            // Mark complex areas for further sphere-to-mesh collision
+            // detection
+            if (std::abs(diff) >= min_walkable_climb_cells &&
+                std::abs(diff) <= max_walkable_climb_cells) {
 
-              break;
+              new_area = change_area(new_area, RC_COMPLEX_AREA);
             }
           }
 
-          if (direction_allowed) {
-            span->area = allow_direction(span->area, direction);
-          }
+          break;
         }
       }
+
+      if (direction_allowed) {
+        new_area = allow_direction(new_area, direction);
+      }
     }
+
+    areas[span] = static_cast<std::uint8_t>(new_area);
   }
 }
 
 void NSWE::calculate_complex_nswe() {
-  for (auto y = 0; y < m_hf->height; ++y) {
-    for (auto x = 0; x < m_hf->width; ++x) {
-      print_progress(x, y);
+  std::atomic<int> completed_rows = 0;
+  std::atomic<int> derived = 0;
+
+  // Results are kept aside until the pass is over, in the symmetric mode a
+  // column also writes results of its neighbour spans
+  DirectionResults results;
+
+  for (auto &direction_results : results) {
+    direction_results.assign(m_hf.span_count(), COLLISION_UNTESTED);
+  }
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    m_job_pool.submit([this, y, &results, &completed_rows,
+                       &derived](std::size_t) {
+      auto row_derived = 0;
+
+      for (auto x = 0; x < m_hf.width; ++x) {
+        row_derived += calculate_complex_nswe(x, y, results);
+      }
+
+      derived += row_derived;
+      print_progress(++completed_rows);
+    });
+  }
+
+  m_job_pool.wait();
+
+#ifdef NSWE_VALIDATION
+  validate_complex_nswe(results);
+#endif
+
+  for (std::size_t span = 0; span < m_hf.span_count(); ++span) {
+    auto &span_area = m_hf.areas[span];
 
-      for (auto *span = m_hf->spans[x + y * m_hf->width]; span != nullptr;
-           span = span->next) {
+    for (auto direction = 0; direction < 4; ++direction) {
+      const auto result = results[direction][span];
+
+      if (result == COLLISION_BLOCKED) {
+        span_area =
+            static_cast<std::uint8_t>(forbid_direction(span_area, direction));
+      } else if (result == COLLISION_ALLOWED) {
+#ifndef ENABLE_SIMPLE_NSWE_CALCULATION
+        span_area =
+            static_cast<std::uint8_t>(allow_direction(span_area, direction));
+#endif
+      }
+    }
+  }
+
+  utils::Log(utils::LOG_DEBUG, "Geodata")
+      << "Complex NSWE directions derived from reverse sweeps: " << derived
+      << std::endl;
+}
+
+auto NSWE::calculate_complex_nswe(int x, int y,
+                                  DirectionResults &results) const -> int {
+  const auto column = x + y * m_hf.width;
+  auto derived = 0;
+
+  for (auto span = m_hf.column_begin(column); span < m_hf.column_end(column);
+       ++span) {
 
 #ifdef ENABLE_SIMPLE_NSWE_CALCULATION
-        const auto area = unpack_area(span->area);
+    const auto span_area = m_hf.areas[span];
+    const auto area = unpack_area(span_area);
 
-        if (area != RC_COMPLEX_AREA) {
-          continue;
-        }
+    if (area != RC_COMPLEX_AREA) {
+      continue;
+    }
 #endif
 
-        for (auto direction = 0; direction < 4; ++direction) {
+    for (auto direction = 0; direction < 4; ++direction) {
 #ifdef ENABLE_SIMPLE_NSWE_CALCULATION
-          // Skip collision checking if direction is already forbidden at the
-          // simple NSWE calculation step
-          if (direction_forbidden(span->area, direction)) {
-            continue;
-          }
+      // Skip collision checking if direction is already forbidden at the
+      // simple NSWE calculation step
+      if (direction_forbidden(span_area, direction)) {
+        continue;
+      }
 #endif
 
-          const auto dx = rcGetDirOffsetX(direction);
-          const auto dy = rcGetDirOffsetY(direction);
-          const auto side_x = x + dx;
-          const auto side_y = y + dy;
+      const auto dx = rcGetDirOffsetX(direction);
+      const auto dy = rcGetDirOffsetY(direction);
+      const auto side_x = x + dx;
+      const auto side_y = y + dy;
 
-          // Skip map edges
-          if (side_x < 0 || side_y < 0 || side_x >= m_hf->width ||
-              side_y >= m_hf->height) {
+      // Skip map edges
+      if (side_x < 0 || side_y < 0 || side_x >= m_hf.width ||
+          side_y >= m_hf.height) {
 
-            continue;
-          }
+        continue;
+      }
 
-          if (slide_sphere_until_collision(x, y, span->smax, direction)) {
-            span->area = forbid_direction(span->area, direction);
-          } else {
-#ifndef ENABLE_SIMPLE_NSWE_CALCULATION
-            span->area = allow_direction(span->area, direction);
+#ifdef NSWE_SYMMETRIC_COLLISION
+      // Directions 1 (+y) and 2 (+x) own the shared edge, the other two are
+      // written by the neighbour column
+      const auto owner = direction == 1 || direction == 2;
+      const auto pair = paired_span(x, y, span, direction);
+
+      if (!owner && pair.has_value()) {
+        continue;
+      }
+#endif
+
+      const auto blocked =
+          slide_sphere_until_collision(x, y, m_hf.smax[span], direction);
+
+      results[direction][span] =
+          blocked ? COLLISION_BLOCKED : COLLISION_ALLOWED;
+
+#ifdef NSWE_SYMMETRIC_COLLISION
+      if (!owner || !pair.has_value()) {
+        continue;
+      }
+
+      const auto reverse = (direction + 2) % 4;
+      const auto neighbour = *pair;
+      const auto diff = static_cast<int>(m_hf.smax[neighbour]) -
+                        static_cast<int>(m_hf.smax[span]);
+
+      // Walls across the edge stop both directions, only the climb differs:
+      // - same height: the reverse move meets the same geometry
+      // - passable climb: the descent back is passable too
+      // - blocked descent: the climb back is blocked too
+      // Otherwise the reverse direction gets its own sweep.
+      auto reverse_blocked = blocked;
+
+      if (diff == 0 || (diff > 0 && !blocked) || (diff < 0 && blocked)) {
+        ++derived;
+      } else {
+        reverse_blocked =
+            slide_sphere_until_collision(x + dx, y + dy,
+                                         m_hf.smax[neighbour], reverse);
+      }
+
+      results[reverse][neighbour] =
+          reverse_blocked ? COLLISION_BLOCKED : COLLISION_ALLOWED;
+#endif
+    }
+  }
+
+  return derived;
+}
+
+#ifdef NSWE_SYMMETRIC_COLLISION
+// Same search as in calculate_simple_nswe: first neighbour span with enough
+// room for the actor
+auto NSWE::passable_neighbour(int x, int y, std::uint32_t span,
+                              int direction) const
+    -> std::optional<std::uint32_t> {
+
+  const auto actor_height_cells =
+      static_cast<int>(m_actor_height / m_cell_height);
+
+  const auto column = x + y * m_hf.width;
+  const auto side_column = x + rcGetDirOffsetX(direction) +
+                           (y + rcGetDirOffsetY(direction)) * m_hf.width;
+
+  const auto bottom = static_cast<int>(m_hf.smax[span]);
+  const auto top = m_hf.top(column, span);
+
+  for (auto neighbour = m_hf.column_begin(side_column);
+       neighbour < m_hf.column_end(side_column); ++neighbour) {
+
+    const auto neighbour_bottom = static_cast<int>(m_hf.smax[neighbour]);
+    const auto neighbour_top = m_hf.top(side_column, neighbour);
+
+    if (std::min(top, neighbour_top) - std::max(bottom, neighbour_bottom) >
+        actor_height_cells) {
+
+      return neighbour;
+    }
+  }
+
+  return std::nullopt;
+}
+
+// Both spans of a pair must be tested in the directions facing each other and
+// must be each other's passable neighbours, so the owner and the other column
+// come to the same answer
+auto NSWE::paired_span(int x, int y, std::uint32_t span, int direction) const
+    -> std::optional<std::uint32_t> {
+
+  const auto neighbour = passable_neighbour(x, y, span, direction);
+
+  if (!neighbour.has_value()) {
+    return std::nullopt;
+  }
+
+  const auto side_x = x + rcGetDirOffsetX(direction);
+  const auto side_y = y + rcGetDirOffsetY(direction);
+  const auto reverse = (direction + 2) % 4;
+
+#ifdef ENABLE_SIMPLE_NSWE_CALCULATION
+  const auto neighbour_area = m_hf.areas[*neighbour];
+
+  if (unpack_area(neighbour_area) != RC_COMPLEX_AREA ||
+      direction_forbidden(neighbour_area, reverse)) {
+
+    return std::nullopt;
+  }
+#endif
+
+  if (passable_neighbour(side_x, side_y, *neighbour, reverse) != span) {
+    return std::nullopt;
+  }
+
+  return neighbour;
+}
 #endif
+
+#ifdef NSWE_VALIDATION
+void NSWE::validate_complex_nswe(const DirectionResults &results) const {
+  std::atomic<int> tested = 0;
+  std::atomic<int> mismatches = 0;
+
+  for (auto y = 0; y < m_hf.height; ++y) {
+    m_job_pool.submit([this, y, &results, &tested, &mismatches](std::size_t) {
+      for (auto x = 0; x < m_hf.width; ++x) {
+        const auto column = x + y * m_hf.width;
+
+        for (auto span = m_hf.column_begin(column);
+             span < m_hf.column_end(column); ++span) {
+
+          for (auto direction = 0; direction < 4; ++direction) {
+            const auto result = results[direction][span];
+
+            if (result == COLLISION_UNTESTED) {
+              continue;
+            }
+
+            const auto blocked = slide_sphere_until_collision(
+                x, y, m_hf.smax[span], direction);
+
+            ++tested;
+
+            if (blocked != (result == COLLISION_BLOCKED)) {
+              ++mismatches;
+            }
           }
         }
       }
+    });
+  }
+
+  m_job_pool.wait();
+
+  utils::Log(mismatches > 0 ? utils::LOG_WARN : utils::LOG_INFO, "Geodata")
+      << "Complex NSWE validation: " << mismatches << " of " << tested
+      << " directions differ from the per-direction calculation"
+      << std::endl;
+}
+#endif
+
+#ifdef NSWE_SWEPT_COLLISION
+// Continuous version of the stepping below, queries go through the map BVH
+// instead of the column triangle lists. The sphere is moved in segments no
+// longer than its radius, lifted by the same climb allowance before each one
+// and snapped to the ground after it. On a walkable contact (ramp, small step)
+// the rest of the segment goes along the contact surface. A handful of sweeps
+// per direction instead of a point test per unit of movement. Results differ
+// from the stepping version on a fraction of a percent of cells, mostly
+// directions the stepping blocks and the sweeps let through.
+auto NSWE::slide_sphere_until_collision(int x, int y, int z,
+                                        int direction) const -> bool {
+
+  static constexpr auto climb = 1.0f;
+  static constexpr auto max_segments = 16;
+
+  const auto map_origin = m_map.bounding_box().min();
+  const auto sphere_radius = 16.0f;
+
+  const auto dx = rcGetDirOffsetX(direction);
+  const auto dy = rcGetDirOffsetY(direction);
+
+  // Place sphere on the cell
+  const glm::vec3 sphere_center{
+      map_origin.x + (x - dx * 0.5f) * m_cell_size + m_cell_size / 2.0f,
+      map_origin.z + z * m_cell_height +
+          sphere_radius * 2.0f, // Z-up swapped with Y-up
+      map_origin.y + (y - dy * 0.5f) * m_cell_size + m_cell_size / 2.0f,
+  };
+
+  const glm::vec3 forward{static_cast<float>(dx), 0.0f,
+                          static_cast<float>(dy)};
+
+  geometry::Sphere sphere{sphere_center, sphere_radius};
+
+  // Moves the sphere until the first contact, returns the moved fraction
+  const auto move_sphere = [&](const glm::vec3 &movement,
+                               geometry::SweepIntersection &intersection) {
+    if (!sweep_sphere(sphere, movement, intersection)) {
+      sphere.center += movement;
+      return 1.0f;
     }
+
+    sphere.center += movement * intersection.time;
+    return intersection.time;
+  };
+
+  drop_sphere(sphere);
+
+  const auto distance = m_cell_size * 1.5f;
+  auto travelled = 0.0f;
+
+  for (auto i = 0; i < max_segments && travelled < distance; ++i) {
+    const auto length = std::min(sphere_radius, distance - travelled);
+    geometry::SweepIntersection intersection{};
+
+    // Stops under a ceiling
+    move_sphere({0.0f, climb, 0.0f}, intersection);
+
+    const auto moved = move_sphere(forward * length, intersection);
+    travelled += length * moved;
+
+    if (moved < 1.0f) {
+      if (vertical_slope(intersection.normal) < 0.3f) {
+        return true;
+      }
+
+      // Climb: the rest of the segment along the surface, with the same
+      // horizontal length (slope check above keeps the tangent non-vertical)
+      const auto tangent =
+          forward -
+          intersection.normal * glm::dot(forward, intersection.normal);
+      const auto rest = length * (1.0f - moved);
+
+      const auto climbed = move_sphere(
+          tangent * (rest / glm::dot(tangent, forward)), intersection);
+      travelled += rest * climbed;
+
+      if (climbed < 1.0f && vertical_slope(intersection.normal) < 0.3f) {
+        return true;
+      }
+    }
+
+    drop_sphere(sphere);
   }
+
+  // Segments ran out short of the distance: the sphere is stuck
+  return travelled < distance;
 }
 
+auto NSWE::sweep_sphere(const geometry::Sphere &sphere,
+                        const glm::vec3 &movement,
+                        geometry::SweepIntersection &intersection) const
+    -> bool {
+
+#ifdef NSWE_DISTANCE_FIELD
+  return m_distance_field.sweep(sphere, movement, intersection);
+#else
+  return m_bvh.sweep(sphere, movement, intersection);
+#endif
+}
+
+// Analytic ground snap: the sphere is moved down until it touches a triangle
+void NSWE::drop_sphere(geometry::Sphere &sphere) const {
+
+  const glm::vec3 movement{0.0f, -m_max_walkable_climb * 2.0f, 0.0f};
+  geometry::SweepIntersection intersection{};
+
+  sphere.center += sweep_sphere(sphere, movement, intersection)
+                       ? movement * intersection.time
+                       : movement;
+}
+#else
 // TODO: Naive and very slow implementation
 auto NSWE::slide_sphere_until_collision(int x, int y, int z,
                                         int direction) const -> bool {
 
   static constexpr auto delta = 1.0f;
 
-  static const auto triangles_fetch_radius =
-      static_cast<int>(std::ceil(m_actor_radius * 2.0f / m_cell_size));
-
   const auto map_origin = m_map.bounding_box().min();
   const auto sphere_radius = 16;
 
@@ -295,7 +1154,7 @@ auto NSWE::slide_sphere_until_collision(int x, int y, int z,
 
   geometry::Sphere sphere{sphere_center, sphere_radius};
 
-  const auto triangles = triangles_at_columns(x, y, triangles_fetch_radius);
+  const auto triangles = triangles_at_columns(x, y);
 
   for (auto i = 0; i < static_cast<int>(m_cell_size * 1.5f / delta); ++i) {
     drop_sphere(sphere, triangles);
@@ -303,17 +1162,14 @@ auto NSWE::slide_sphere_until_collision(int x, int y, int z,
     sphere.center.x += dx * delta;
     sphere.center.z += dy * delta;
 
-    for (const auto &triangle : triangles) {
-      geometry::Intersection intersection{};
-
-      if (sphere.intersects(triangle, intersection)) {
-        const auto slope =
-            vertical_slope(intersection.normal * intersection.depth);
+    const auto blocked = triangles.intersects(
+        sphere, [](const geometry::Intersection &intersection) {
+          return vertical_slope(intersection.normal * intersection.depth) <
+                 0.3f;
+        });
 
-        if (slope < 0.3f) {
-          return true;
-        }
-      }
+    if (blocked) {
+      return true;
     }
 
     sphere.center.y += delta;
@@ -323,14 +1179,14 @@ auto NSWE::slide_sphere_until_collision(int x, int y, int z,
 }
 
 void NSWE::drop_sphere(geometry::Sphere &sphere,
-                       const std::vector<geometry::Triangle> &triangles) const {
+                       const TriangleCandidates &triangles) const {
 
   static constexpr auto delta = 1.0f;
 
   const auto original_z = sphere.center.y;
 
   while (original_z - sphere.center.y < m_max_walkable_climb * 2.0f) {
-    if (sphere.intersects(triangles)) {
+    if (triangles.intersects(sphere)) {
       if (sphere.center.y != original_z) {
         sphere.center.y += delta;
       }
@@ -341,69 +1197,31 @@ void NSWE::drop_sphere(geometry::Sphere &sphere,
     sphere.center.y -= delta;
   }
 }
+#endif
 
-auto NSWE::triangles_at_columns(int x, int y, int radius) const
-    -> std::vector<geometry::Triangle> {
-
-  auto &triangles = m_triangle_cache[x + y * m_hf->width];
-
-  if (triangles.empty()) {
-    std::unordered_set<int> column_indices;
-
-    const auto &map_vertices = m_map.vertices();
-    const auto &map_triangles = m_map.indices();
-
-    // Find triangle indices
-    for (auto dy = y - radius; dy < y + radius + 1; ++dy) {
-      for (auto dx = x - radius; dx < x + radius + 1; ++dx) {
-        if (dx < 0 || dy < 0 || dx >= m_hf->width || dy >= m_hf->height) {
-          continue;
-        }
-
-        const auto &indices = m_triangle_index[dx + dy * m_hf->width];
-        column_indices.insert(indices.cbegin(), indices.cend());
-      }
-    }
-
-    // Make triangles by found indices
-    for (const auto index : column_indices) {
-      const geometry::Triangle triangle{
-          map_vertices[map_triangles[index * 3 + 0]],
-          map_vertices[map_triangles[index * 3 + 1]],
-          map_vertices[map_triangles[index * 3 + 2]],
-      };
-
-      triangles.push_back(triangle);
-    }
-  }
-
-  return triangles;
+auto NSWE::triangles_at_columns(int x, int y) const -> TriangleCandidates {
+  return TriangleCandidates{m_triangle_cache.at(x + y * m_hf.width),
+                            m_map.vertices(), m_map.indices(),
+                            m_map.internal_bounding_box().min().y,
+                            m_cell_height};
 }
 
-void NSWE::print_progress(int x, int y) const {
+void NSWE::print_progress(int completed_rows) const {
   if (utils::Log::level < utils::LOG_INFO) {
     return;
   }
 
-  const auto current = (x + 1) + (y + 1) * m_hf->width;
-  const auto total = m_hf->height * m_hf->width;
-
-  if (current == total) {
+  if (completed_rows == m_hf.height) {
     std::cout << std::endl;
     return;
   }
 
-  const auto part = total / 100;
+  // Dot per percent, rows are completed in any order
+  const auto percent = completed_rows * 100 / m_hf.height;
 
-  if (part == 0) {
-    return;
+  if (percent != (completed_rows - 1) * 100 / m_hf.height) {
+    std::cout << ".";
   }
-
-  if (current % part != 0) {
-    return;
-  }
-
-  std::cout << ".";
 }
 
 } // namespace geodata
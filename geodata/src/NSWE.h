@@ -1,13 +1,24 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include <geodata/Map.h>
+#include <geometry/BVH.h>
 #include <geometry/Sphere.h>
 #include <geometry/Triangle.h>
+#include <utils/Arena.h>
+#include <utils/JobPool.h>
 
+#include "DistanceField.h"
+#include "Heightfield.h"
 #include "Recast.h"
+#include "TriangleCandidates.h"
 
 namespace geodata {
 
@@ -23,11 +34,10 @@ class NSWE {
 public:
   explicit NSWE(const Map &map, float actor_height, float actor_radius,
                 float max_walkable_angle, float min_walkable_climb,
-                float max_walkable_climb, float cell_size, float cell_height);
+                float max_walkable_climb, float cell_size, float cell_height,
+                utils::JobPool &job_pool, utils::Arena &arena);
 
-  ~NSWE();
-
-  auto calculate_nswe() -> const rcHeightfield &;
+  auto calculate_nswe() -> const Heightfield &;
 
 private:
   const Map &m_map;
@@ -39,35 +49,117 @@ private:
   const float m_max_walkable_climb;
   const float m_cell_size;
   const float m_cell_height;
-
-  rcHeightfield *m_hf;
-  std::vector<std::vector<int>> m_triangle_index;
-
-  mutable std::vector<std::vector<geometry::Triangle>> m_triangle_cache;
-
-  // Build heightfield and filter walkable low-height spans
-  void build_filtered_heightfield();
+  const int m_triangles_fetch_radius;
+
+  utils::JobPool &m_job_pool;
+
+  // Per-map memory: Recast allocations of the NSWE threads, heightfield and
+  // column lists
+  utils::Arena &m_arena;
+
+#ifdef NSWE_SWEPT_COLLISION
+  // Collision queries of the swept sphere path
+  const geometry::BVH m_bvh;
+#endif
+
+  // Optional replacement of the BVH queries, built around complex columns
+  // after the simple NSWE calculation
+  DistanceField m_distance_field;
+
+  // Compressed sparse row lists of triangles with their span intervals,
+  // entries of a column are values[offsets[column]..offsets[column + 1])
+  struct ColumnLists {
+    std::pmr::vector<std::uint32_t> offsets;
+    std::pmr::vector<ColumnTriangle> values;
+
+    explicit ColumnLists(std::pmr::memory_resource *resource)
+        : offsets{resource}, values{resource} {}
+
+    auto at(int column) const -> std::span<const ColumnTriangle> {
+      return {values.data() + offsets[column],
+              offsets[column + 1] - offsets[column]};
+    }
+  };
+
+  // Triangles rasterized into a column (ascending), filled while the
+  // heightfield is built
+  ColumnLists m_triangle_index;
+
+  Heightfield m_hf;
+
+  // Collision candidates of the columns with complex spans: triangles of the
+  // columns within the fetch radius, intervals merged over these columns
+  ColumnLists m_triangle_cache;
+
+  // Build heightfield, filter walkable low-height spans and make the compact
+  // copy
+  auto build_filtered_heightfield() -> Heightfield;
+  void rasterize_tiles(rcHeightfield &hf, const float *vertices,
+                       int vertex_count, const int *triangles,
+                       std::span<const unsigned char> areas,
+                       std::pmr::vector<rcTriangleColumn> *triangle_columns);
   void mark_walkable_triangles(const float *vertices, const int *triangles,
                                std::size_t triangle_count,
                                unsigned char *areas) const;
 
+  // Column lists are used only by the stepping collision path, both are built
+  // in count and fill passes
+  void build_triangle_index(std::span<const rcTriangleColumn> triangle_columns,
+                            int column_count);
+  void build_triangle_cache();
+  void collect_column_triangles(int x, int y,
+                                std::vector<ColumnTriangle> &triangles) const;
+  auto has_complex_spans(int x, int y) const -> bool;
+
+  void build_distance_field();
+
   // Calculate NSWE based on the height difference of the neighboring spans and
   // mark some areas as RC_COMPLEX_AREA, on which we'll use
-  // calculate_complex_nswe
+  // calculate_complex_nswe. Rows are processed in parallel, new areas are
+  // written to the output (indexed like spans) and replace the old ones after
+  // the pass. Runs of single-layer columns are vectorized where possible.
   void calculate_simple_nswe();
+  void calculate_simple_nswe_row(int y, std::uint8_t *areas) const;
+  void calculate_simple_nswe(int x, int y, std::uint8_t *areas) const;
+
+  // Collision results of the complex pass per direction, indexed like spans
+  using DirectionResults = std::array<std::vector<std::uint8_t>, 4>;
 
   // Calculate NSWE based on sphere-to-mesh collision, must be called after
-  // calculate_simple_nswe
+  // calculate_simple_nswe. Rows are processed in parallel, every direction of
+  // a span is written by one column only, so the result doesn't depend on the
+  // thread count. In the symmetric mode a shared edge of two complex spans is
+  // swept once and the reverse direction is derived from it where the climb
+  // allows, column returns the number of derived directions.
   void calculate_complex_nswe();
+  auto calculate_complex_nswe(int x, int y, DirectionResults &results) const
+      -> int;
+  auto passable_neighbour(int x, int y, std::uint32_t span,
+                          int direction) const
+      -> std::optional<std::uint32_t>;
+  auto paired_span(int x, int y, std::uint32_t span, int direction) const
+      -> std::optional<std::uint32_t>;
+
+  // Compares the results with the plain per-direction calculation
+  void validate_complex_nswe(const DirectionResults &results) const;
+
   auto slide_sphere_until_collision(int x, int y, int z, int direction) const
       -> bool;
+#ifdef NSWE_SWEPT_COLLISION
+  void drop_sphere(geometry::Sphere &sphere) const;
+  auto sweep_sphere(const geometry::Sphere &sphere, const glm::vec3 &movement,
+                    geometry::SweepIntersection &intersection) const -> bool;
+#else
   void drop_sphere(geometry::Sphere &sphere,
-                   const std::vector<geometry::Triangle> &triangles) const;
-  auto triangles_at_columns(int x, int y, int radius) const
-      -> std::vector<geometry::Triangle>;
+                   const TriangleCandidates &triangles) const;
+#endif
+
+  // View into the candidate cache, valid while NSWE is alive. Queries skip
+  // triangles out of the vertical range of the sphere.
+  auto triangles_at_columns(int x, int y) const -> TriangleCandidates;
 
   // Utility
-  void print_progress(int x, int y) const;
+  void print_progress(int completed_rows) const;
 };
 
 } // namespace geodata
@@ -0,0 +1,62 @@
+#include "pch.h"
+
+#include "RecastAllocator.h"
+
+#include <utils/Arena.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace geodata {
+
+// Recast frees without a size, so blocks start with a header telling where
+// they came from
+struct alignas(std::max_align_t) AllocationHeader {
+  std::size_t size;
+  utils::Arena *arena;
+};
+
+static auto allocate(std::size_t size, rcAllocHint) -> void * {
+  auto *arena = utils::Arena::current();
+  const auto total = size + sizeof(AllocationHeader);
+
+  void *block = nullptr;
+
+  if (arena != nullptr) {
+    try {
+      block = arena->allocate(total, alignof(AllocationHeader));
+    } catch (const std::bad_alloc &) {
+      return nullptr;
+    }
+  } else {
+    block = std::malloc(total);
+  }
+
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  return new (block) AllocationHeader{total, arena} + 1;
+}
+
+static void deallocate(void *pointer) {
+  if (pointer == nullptr) {
+    return;
+  }
+
+  auto *header = static_cast<AllocationHeader *>(pointer) - 1;
+
+  if (header->arena != nullptr) {
+    header->arena->deallocate(header, header->size, alignof(AllocationHeader));
+  } else {
+    std::free(header);
+  }
+}
+
+void install_recast_allocator() {
+  static std::once_flag installed;
+  std::call_once(installed, [] { rcAllocSetCustom(allocate, deallocate); });
+}
+
+} // namespace geodata
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace geodata {
+
+// Routes Recast allocations of a thread to its current utils::Arena, threads
+// without one use malloc. Safe to call more than once.
+void install_recast_allocator();
+
+} // namespace geodata
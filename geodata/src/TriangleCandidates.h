@@ -0,0 +1,96 @@
+#pragma once
+
+#include <geometry/Intersection.h>
+#include <geometry/Sphere.h>
+#include <geometry/Triangle.h>
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace geodata {
+
+// Triangle index with the heightfield interval (in cells) of the span it
+// produced in a column
+struct ColumnTriangle {
+  int triangle;
+  std::uint16_t smin;
+  std::uint16_t smax;
+};
+
+// Non-owning view of collision candidates: triangles of an indexed mesh with
+// their vertical extents. Triangles are made on access, nothing is copied up
+// front.
+//
+// Span intervals are conservative (floored bottom, ceiled top) and cover the
+// triangle within each rasterized column, so queries skip candidates whose
+// interval misses the vertical range of the sphere without changing results.
+class TriangleCandidates {
+public:
+  // Intervals are in cells of `cell_height` above `bottom` (heightfield
+  // origin)
+  explicit TriangleCandidates(std::span<const ColumnTriangle> triangles,
+                              const std::vector<glm::vec3> &vertices,
+                              const std::vector<unsigned int> &indices,
+                              float bottom, float cell_height)
+      : m_triangles{triangles}, m_vertices{vertices}, m_indices{indices},
+        m_bottom{bottom}, m_cell_height{cell_height} {}
+
+  auto size() const -> std::size_t { return m_triangles.size(); }
+
+  auto operator[](std::size_t i) const -> geometry::Triangle {
+    const auto index = static_cast<std::size_t>(m_triangles[i].triangle) * 3;
+
+    return geometry::Triangle{
+        m_vertices[m_indices[index + 0]],
+        m_vertices[m_indices[index + 1]],
+        m_vertices[m_indices[index + 2]],
+    };
+  }
+
+  // Any candidate touching the sphere
+  auto intersects(const geometry::Sphere &sphere) const -> bool {
+    return intersects(sphere, [](const auto &) { return true; });
+  }
+
+  // Any candidate touching the sphere for which the predicate returns true
+  template <typename Predicate>
+  auto intersects(const geometry::Sphere &sphere, Predicate &&predicate) const
+      -> bool {
+
+    const auto sphere_bottom =
+        (sphere.center.y - sphere.radius - m_bottom) / m_cell_height;
+    const auto sphere_top =
+        (sphere.center.y + sphere.radius - m_bottom) / m_cell_height;
+
+    for (std::size_t i = 0; i < size(); ++i) {
+      const auto &triangle = m_triangles[i];
+
+      if (triangle.smax < sphere_bottom || triangle.smin > sphere_top) {
+        continue;
+      }
+
+      geometry::Intersection intersection{};
+
+      if (sphere.intersects((*this)[i], intersection) &&
+          predicate(intersection)) {
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+private:
+  const std::span<const ColumnTriangle> m_triangles;
+  const std::vector<glm::vec3> &m_vertices;
+  const std::vector<unsigned int> &m_indices;
+  const float m_bottom;
+  const float m_cell_height;
+};
+
+} // namespace geodata
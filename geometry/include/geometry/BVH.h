@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Intersection.h"
+#include "Sphere.h"
+#include "Triangle.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace geometry {
+
+// Static bounding volume hierarchy over an indexed triangle mesh. Built with
+// binned SAH, nodes are stored depth-first in a flat array (left child follows
+// its parent). Queries are thread-safe.
+class BVH {
+public:
+  explicit BVH(const std::vector<glm::vec3> &vertices,
+               const std::vector<unsigned int> &indices);
+
+  // Any triangle touching the sphere
+  auto intersects(const Sphere &sphere) const -> bool;
+
+  // Any triangle touching the sphere for which the predicate returns true
+  auto intersects(const Sphere &sphere,
+                  const std::function<bool(const Intersection &)> &predicate)
+      const -> bool;
+
+  // Earliest contact of the sphere moving by `movement` (see Sphere::sweep)
+  auto sweep(const Sphere &sphere, const glm::vec3 &movement,
+             SweepIntersection &intersection) const -> bool;
+
+private:
+  struct Node {
+    glm::vec3 min;
+    std::uint32_t offset; // First triangle of a leaf or right child index
+    glm::vec3 max;
+    std::uint32_t count; // Triangle count, 0 for inner nodes
+  };
+
+  std::vector<Node> m_nodes;
+  std::vector<Triangle> m_triangles; // Ordered by leaves
+
+  auto build(std::vector<std::uint32_t> &triangle_indices,
+             const std::vector<glm::vec3> &centroids,
+             const std::vector<glm::vec3> &mins,
+             const std::vector<glm::vec3> &maxs, std::uint32_t begin,
+             std::uint32_t end, int depth) -> std::uint32_t;
+};
+
+} // namespace geometry
@@ -9,4 +9,9 @@ struct Intersection {
   float depth;
 };
 
+struct SweepIntersection {
+  glm::vec3 normal; // From the contact point to the sphere center
+  float time;       // Fraction of the movement, 0 if touching at the start
+};
+
 } // namespace geometry
@@ -21,6 +21,16 @@ struct Sphere {
       -> bool;
 
   auto intersects(const std::vector<Triangle> &triangles) const -> bool;
+
+  // First contact of the sphere moving by `movement` (continuous, so thin
+  // triangles can't be skipped). Triangles are double-sided, touched triangles
+  // don't stop the sphere moving away from them.
+  auto sweep(const glm::vec3 &movement, const Triangle &triangle,
+             SweepIntersection &intersection) const -> bool;
+
+  // Earliest contact among the triangles
+  auto sweep(const glm::vec3 &movement, const std::vector<Triangle> &triangles,
+             SweepIntersection &intersection) const -> bool;
 };
 
 } // namespace geometry
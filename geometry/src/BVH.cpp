@@ -0,0 +1,344 @@
+#include <geometry/BVH.h>
+
+#include <utils/Assert.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace geometry {
+
+static constexpr auto BIN_COUNT = 16;
+static constexpr auto MAX_LEAF_SIZE = 4;
+
+// Also bounds the traversal stack
+static constexpr auto MAX_DEPTH = 64;
+
+static auto surface_area(const glm::vec3 &min, const glm::vec3 &max)
+    -> float {
+
+  const auto size = max - min;
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+// Squared distance from the point to the box
+static auto distance2(const glm::vec3 &point, const glm::vec3 &min,
+                      const glm::vec3 &max) -> float {
+
+  const auto closest = glm::clamp(point, min, max);
+  const auto vector = point - closest;
+  return glm::dot(vector, vector);
+}
+
+// Segment from `origin` to `origin + movement * max_time` against the box
+static auto segment_overlaps(const glm::vec3 &origin,
+                             const glm::vec3 &movement, float max_time,
+                             const glm::vec3 &min, const glm::vec3 &max)
+    -> bool {
+
+  auto t_min = 0.0f;
+  auto t_max = max_time;
+
+  for (auto axis = 0; axis < 3; ++axis) {
+    if (std::abs(movement[axis]) < std::numeric_limits<float>::epsilon()) {
+      if (origin[axis] < min[axis] || origin[axis] > max[axis]) {
+        return false;
+      }
+
+      continue;
+    }
+
+    const auto inverse = 1.0f / movement[axis];
+    auto t1 = (min[axis] - origin[axis]) * inverse;
+    auto t2 = (max[axis] - origin[axis]) * inverse;
+
+    if (t1 > t2) {
+      std::swap(t1, t2);
+    }
+
+    t_min = std::max(t_min, t1);
+    t_max = std::min(t_max, t2);
+
+    if (t_min > t_max) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+BVH::BVH(const std::vector<glm::vec3> &vertices,
+         const std::vector<unsigned int> &indices) {
+
+  ASSERT(indices.size() % 3 == 0, "Geometry",
+         "Index count must be a multiple of 3");
+
+  const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+
+  std::vector<std::uint32_t> triangle_indices(triangle_count);
+  std::vector<glm::vec3> centroids(triangle_count);
+  std::vector<glm::vec3> mins(triangle_count);
+  std::vector<glm::vec3> maxs(triangle_count);
+
+  for (std::uint32_t i = 0; i < triangle_count; ++i) {
+    const auto &a = vertices[indices[i * 3 + 0]];
+    const auto &b = vertices[indices[i * 3 + 1]];
+    const auto &c = vertices[indices[i * 3 + 2]];
+
+    triangle_indices[i] = i;
+    centroids[i] = (a + b + c) / 3.0f;
+    mins[i] = glm::min(a, glm::min(b, c));
+    maxs[i] = glm::max(a, glm::max(b, c));
+  }
+
+  // Binary tree with at least a triangle per leaf
+  m_nodes.reserve(std::max(triangle_count, 1u) * 2 - 1);
+  build(triangle_indices, centroids, mins, maxs, 0, triangle_count, 0);
+
+  m_triangles.reserve(triangle_count);
+
+  for (const auto index : triangle_indices) {
+    m_triangles.emplace_back(vertices[indices[index * 3 + 0]],
+                             vertices[indices[index * 3 + 1]],
+                             vertices[indices[index * 3 + 2]]);
+  }
+}
+
+auto BVH::build(std::vector<std::uint32_t> &triangle_indices,
+                const std::vector<glm::vec3> &centroids,
+                const std::vector<glm::vec3> &mins,
+                const std::vector<glm::vec3> &maxs, std::uint32_t begin,
+                std::uint32_t end, int depth) -> std::uint32_t {
+
+  const auto node_index = static_cast<std::uint32_t>(m_nodes.size());
+  m_nodes.push_back({});
+
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+  glm::vec3 centroid_min{std::numeric_limits<float>::max()};
+  glm::vec3 centroid_max{std::numeric_limits<float>::lowest()};
+
+  for (auto i = begin; i < end; ++i) {
+    const auto index = triangle_indices[i];
+    min = glm::min(min, mins[index]);
+    max = glm::max(max, maxs[index]);
+    centroid_min = glm::min(centroid_min, centroids[index]);
+    centroid_max = glm::max(centroid_max, centroids[index]);
+  }
+
+  const auto make_leaf = [&] {
+    m_nodes[node_index] = {min, begin, max, end - begin};
+    return node_index;
+  };
+
+  const auto count = end - begin;
+
+  if (count <= MAX_LEAF_SIZE || depth + 1 >= MAX_DEPTH) {
+    return make_leaf();
+  }
+
+  // Split along the longest axis of the centroid bounds
+  const auto extent = centroid_max - centroid_min;
+  auto axis = 0;
+
+  if (extent.y > extent[axis]) {
+    axis = 1;
+  }
+
+  if (extent.z > extent[axis]) {
+    axis = 2;
+  }
+
+  if (extent[axis] <= 0.0f) {
+    return make_leaf();
+  }
+
+  struct Bin {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+    std::uint32_t count = 0;
+  };
+
+  std::array<Bin, BIN_COUNT> bins{};
+  const auto scale = BIN_COUNT / extent[axis];
+
+  const auto bin_of = [&](std::uint32_t index) {
+    const auto bin = static_cast<int>(
+        (centroids[index][axis] - centroid_min[axis]) * scale);
+    return std::clamp(bin, 0, BIN_COUNT - 1);
+  };
+
+  for (auto i = begin; i < end; ++i) {
+    const auto index = triangle_indices[i];
+    auto &bin = bins[bin_of(index)];
+    bin.min = glm::min(bin.min, mins[index]);
+    bin.max = glm::max(bin.max, maxs[index]);
+    ++bin.count;
+  }
+
+  // Sweep from the right, then from the left to find the cheapest split
+  std::array<float, BIN_COUNT - 1> right_costs{};
+  Bin right{};
+
+  for (auto i = BIN_COUNT - 1; i > 0; --i) {
+    right.min = glm::min(right.min, bins[i].min);
+    right.max = glm::max(right.max, bins[i].max);
+    right.count += bins[i].count;
+    right_costs[i - 1] =
+        right.count > 0 ? surface_area(right.min, right.max) * right.count
+                        : 0.0f;
+  }
+
+  auto best_cost = std::numeric_limits<float>::max();
+  auto best_split = -1;
+  Bin left{};
+
+  for (auto i = 0; i < BIN_COUNT - 1; ++i) {
+    left.min = glm::min(left.min, bins[i].min);
+    left.max = glm::max(left.max, bins[i].max);
+    left.count += bins[i].count;
+
+    if (left.count == 0 || left.count == count) {
+      continue;
+    }
+
+    const auto cost =
+        surface_area(left.min, left.max) * left.count + right_costs[i];
+
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_split = i;
+    }
+  }
+
+  // Splitting doesn't pay off
+  if (best_split < 0 || best_cost >= surface_area(min, max) * count) {
+    if (count <= MAX_LEAF_SIZE * 4) {
+      return make_leaf();
+    }
+  }
+
+  std::uint32_t middle = 0;
+
+  if (best_split >= 0) {
+    const auto split = std::partition(
+        triangle_indices.begin() + begin, triangle_indices.begin() + end,
+        [&](auto index) { return bin_of(index) <= best_split; });
+    middle = static_cast<std::uint32_t>(split - triangle_indices.begin());
+  } else {
+    middle = begin + count / 2;
+    std::nth_element(triangle_indices.begin() + begin,
+                     triangle_indices.begin() + middle,
+                     triangle_indices.begin() + end, [&](auto a, auto b) {
+                       return centroids[a][axis] < centroids[b][axis];
+                     });
+  }
+
+  build(triangle_indices, centroids, mins, maxs, begin, middle, depth + 1);
+  const auto right_child =
+      build(triangle_indices, centroids, mins, maxs, middle, end, depth + 1);
+
+  m_nodes[node_index] = {min, right_child, max, 0};
+  return node_index;
+}
+
+auto BVH::intersects(const Sphere &sphere) const -> bool {
+  return intersects(sphere, [](const auto &) { return true; });
+}
+
+auto BVH::intersects(
+    const Sphere &sphere,
+    const std::function<bool(const Intersection &)> &predicate) const -> bool {
+
+  if (m_triangles.empty()) {
+    return false;
+  }
+
+  const auto radius2 = sphere.radius * sphere.radius;
+
+  std::array<std::uint32_t, MAX_DEPTH> stack{};
+  std::size_t stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    const auto &node = m_nodes[stack[--stack_size]];
+
+    if (distance2(sphere.center, node.min, node.max) > radius2) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      stack[stack_size++] = node.offset;
+      stack[stack_size++] =
+          static_cast<std::uint32_t>(&node - m_nodes.data()) + 1;
+      continue;
+    }
+
+    for (auto i = node.offset; i < node.offset + node.count; ++i) {
+      Intersection intersection{};
+
+      if (sphere.intersects(m_triangles[i], intersection) &&
+          predicate(intersection)) {
+
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+auto BVH::sweep(const Sphere &sphere, const glm::vec3 &movement,
+                SweepIntersection &intersection) const -> bool {
+
+  if (m_triangles.empty()) {
+    return false;
+  }
+
+  const glm::vec3 radius{sphere.radius};
+  auto found = false;
+  auto time = 1.0f;
+
+  std::array<std::uint32_t, MAX_DEPTH> stack{};
+  std::size_t stack_size = 0;
+  stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    const auto &node = m_nodes[stack[--stack_size]];
+
+    // Path of the center against the node grown by the radius, nodes farther
+    // than the current contact are skipped
+    if (!segment_overlaps(sphere.center, movement, time, node.min - radius,
+                          node.max + radius)) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      stack[stack_size++] = node.offset;
+      stack[stack_size++] =
+          static_cast<std::uint32_t>(&node - m_nodes.data()) + 1;
+      continue;
+    }
+
+    for (auto i = node.offset; i < node.offset + node.count; ++i) {
+      SweepIntersection triangle_intersection{};
+
+      if (sphere.sweep(movement, m_triangles[i], triangle_intersection) &&
+          (!found || triangle_intersection.time < time)) {
+
+        intersection = triangle_intersection;
+        time = triangle_intersection.time;
+        found = true;
+
+        if (time == 0.0f) {
+          return true;
+        }
+      }
+    }
+  }
+
+  return found;
+}
+
+} // namespace geometry
@@ -1,7 +1,38 @@
 #include <geometry/Sphere.h>
 
+#include <array>
+#include <cmath>
+#include <utility>
+
 namespace geometry {
 
+// Smaller root of a*t^2 + b*t + c = 0 if it's in [0, max_root)
+static auto lowest_root(float a, float b, float c, float max_root,
+                        float &root) -> bool {
+
+  const auto determinant = b * b - 4.0f * a * c;
+
+  if (determinant < 0.0f) {
+    return false;
+  }
+
+  const auto sqrt_determinant = std::sqrt(determinant);
+  auto r1 = (-b - sqrt_determinant) / (2.0f * a);
+  auto r2 = (-b + sqrt_determinant) / (2.0f * a);
+
+  if (r1 > r2) {
+    std::swap(r1, r2);
+  }
+
+  // Larger root is the exit time, the sphere can't enter at it
+  if (r1 < 0.0f || r1 >= max_root) {
+    return false;
+  }
+
+  root = r1;
+  return true;
+}
+
 Sphere::Sphere(const glm::vec3 &center, float radius)
     : center{center}, radius{radius} {}
 
@@ -18,6 +49,160 @@ auto Sphere::intersects(const Triangle &triangle,
   return length <= radius;
 }
 
+auto Sphere::sweep(const glm::vec3 &movement, const Triangle &triangle,
+                   SweepIntersection &intersection) const -> bool {
+
+  const auto closest_point = triangle.closest_point_to(center);
+  const auto start_distance = glm::length(center - closest_point);
+
+  const auto plane_normal =
+      glm::cross(triangle.b - triangle.a, triangle.c - triangle.a);
+  const auto plane_normal_length = glm::length(plane_normal);
+
+  // Touching at the start, counts only if moving towards the triangle
+  if (start_distance <= radius) {
+    const auto normal =
+        start_distance > 0.0f ? (center - closest_point) / start_distance
+        : plane_normal_length > 0.0f ? plane_normal / plane_normal_length
+                                     : -glm::normalize(movement);
+
+    if (glm::dot(normal, movement) >= 0.0f) {
+      return false;
+    }
+
+    intersection.time = 0.0f;
+    intersection.normal = normal;
+    return true;
+  }
+
+  // Face: the sphere touches the plane from its side at time t and the contact
+  // point is inside the triangle. It's the earliest possible contact.
+  if (plane_normal_length > 0.0f) {
+    const auto normal = plane_normal / plane_normal_length;
+    const auto distance = glm::dot(normal, center - triangle.a);
+    const auto speed = glm::dot(normal, movement);
+    const auto side = distance >= 0.0f ? 1.0f : -1.0f;
+
+    // Plane is reached through the sphere surface only if it isn't within the
+    // radius already, otherwise the first contact is on an edge or a vertex
+    if (speed * side < 0.0f && std::abs(distance) > radius) {
+      const auto t = (side * radius - distance) / speed;
+
+      if (t <= 1.0f) {
+        const auto point = center + movement * t - normal * (side * radius);
+
+        const auto inside =
+            glm::dot(glm::cross(triangle.b - triangle.a, point - triangle.a),
+                     plane_normal) >= 0.0f &&
+            glm::dot(glm::cross(triangle.c - triangle.b, point - triangle.b),
+                     plane_normal) >= 0.0f &&
+            glm::dot(glm::cross(triangle.a - triangle.c, point - triangle.c),
+                     plane_normal) >= 0.0f;
+
+        if (inside) {
+          intersection.time = t;
+          intersection.normal = normal * side;
+          return true;
+        }
+      }
+    }
+  }
+
+  const auto speed2 = glm::dot(movement, movement);
+
+  if (speed2 == 0.0f) {
+    return false;
+  }
+
+  auto time = 1.0f;
+  auto found = false;
+  glm::vec3 contact_point{};
+
+  const std::array<glm::vec3, 3> vertices = {triangle.a, triangle.b,
+                                             triangle.c};
+
+  // Vertices: |center + t * movement - vertex| = radius
+  for (const auto &vertex : vertices) {
+    const auto to_center = center - vertex;
+    auto t = 0.0f;
+
+    if (lowest_root(speed2, 2.0f * glm::dot(movement, to_center),
+                    glm::dot(to_center, to_center) - radius * radius, time,
+                    t)) {
+      time = t;
+      found = true;
+      contact_point = vertex;
+    }
+  }
+
+  // Edges: distance to the edge line is radius, the contact point is between
+  // the edge vertices
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    const auto &from = vertices[i];
+    const auto edge = vertices[(i + 1) % vertices.size()] - from;
+    const auto to_center = center - from;
+
+    const auto edge2 = glm::dot(edge, edge);
+    const auto edge_movement = glm::dot(edge, movement);
+    const auto edge_center = glm::dot(edge, to_center);
+
+    const auto a = edge2 * speed2 - edge_movement * edge_movement;
+    const auto b = 2.0f * (edge2 * glm::dot(movement, to_center) -
+                           edge_center * edge_movement);
+    const auto c = edge2 * (glm::dot(to_center, to_center) - radius * radius) -
+                   edge_center * edge_center;
+
+    // Moving along the edge, only vertices can be hit
+    if (edge2 == 0.0f || a <= 0.0f) {
+      continue;
+    }
+
+    auto t = 0.0f;
+
+    if (lowest_root(a, b, c, time, t)) {
+      const auto f = (edge_center + edge_movement * t) / edge2;
+
+      if (f >= 0.0f && f <= 1.0f) {
+        time = t;
+        found = true;
+        contact_point = from + edge * f;
+      }
+    }
+  }
+
+  if (found) {
+    intersection.time = time;
+    intersection.normal =
+        glm::normalize(center + movement * time - contact_point);
+  }
+
+  return found;
+}
+
+auto Sphere::sweep(const glm::vec3 &movement,
+                   const std::vector<Triangle> &triangles,
+                   SweepIntersection &intersection) const -> bool {
+
+  auto found = false;
+
+  for (const auto &triangle : triangles) {
+    SweepIntersection triangle_intersection{};
+
+    if (sweep(movement, triangle, triangle_intersection) &&
+        (!found || triangle_intersection.time < intersection.time)) {
+
+      intersection = triangle_intersection;
+      found = true;
+
+      if (intersection.time == 0.0f) {
+        break;
+      }
+    }
+  }
+
+  return found;
+}
+
 auto Sphere::intersects(const std::vector<Triangle> &triangles) const -> bool {
   Intersection intersection{};
 
@@ -0,0 +1,93 @@
+#include "pch.h"
+
+#include "Decryptor.h"
+
+#include <chrono>
+#include <thread>
+
+// Compares package decryption throughput with the original stream based
+// implementation.
+//
+// Usage: unreal-decryptor-benchmark <package>...
+
+static constexpr auto ITERATIONS = 5;
+static constexpr auto LINEAGE_SIZE = 22;
+static constexpr auto VERSION_SIZE = 6;
+
+static void decrypt_stream(const std::filesystem::path &path,
+                           std::ostream &output) {
+
+  std::ifstream input{path, std::ios::binary};
+  input.seekg(LINEAGE_SIZE);
+
+  std::array<char, VERSION_SIZE> version{};
+  input.read(version.data(), VERSION_SIZE);
+
+  auto key = 0xac;
+
+  // v121
+  if (version[2] == '2') {
+    key = 0;
+
+    for (const auto &character : path.filename().string()) {
+      key += std::tolower(character);
+    }
+  }
+
+  std::istreambuf_iterator input_iterator{input};
+  std::ostreambuf_iterator output_iterator{output};
+  std::istreambuf_iterator<char> end;
+
+  for (auto it = input_iterator; it != end; ++it) {
+    *(output_iterator++) = *it ^ key;
+  }
+}
+
+template <typename F> static auto best_time(F &&function) -> double {
+  auto best = std::numeric_limits<double>::max();
+
+  for (auto i = 0; i < ITERATIONS; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+
+  return best;
+}
+
+auto main(int argc, char **argv) -> int {
+  if (argc < 2) {
+    std::cout << "Usage: " << argv[0] << " <package>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  utils::JobPool job_pool{std::max(std::thread::hardware_concurrency(), 1u)};
+  const unreal::Decryptor decryptor{&job_pool};
+
+  for (auto i = 1; i < argc; ++i) {
+    const std::filesystem::path path{argv[i]};
+    const auto megabytes =
+        static_cast<double>(std::filesystem::file_size(path)) /
+        (1024.0 * 1024.0);
+
+    const auto stream_time = best_time([&path] {
+      std::stringstream output;
+      decrypt_stream(path, output);
+    });
+
+    const auto mapped_time = best_time([&path, &decryptor] {
+      std::string output;
+      decryptor.decrypt(path, output);
+    });
+
+    std::cout << path.filename().string() << " (" << megabytes << " MB)"
+              << std::endl;
+    std::cout << "  stream: " << megabytes / stream_time << " MB/s"
+              << std::endl;
+    std::cout << "  mapped: " << megabytes / mapped_time << " MB/s"
+              << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
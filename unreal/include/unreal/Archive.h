@@ -6,14 +6,19 @@
 #include "ObjectLoader.h"
 #include "PropertyExtractor.h"
 
+#include <utils/ByteReader.h>
 #include <utils/ExtractionHelpers.h>
+#include <utils/JobPool.h>
 #include <utils/NonCopyable.h>
 
 #include <cstdint>
 #include <iostream>
+#include <functional>
 #include <memory>
-#include <sstream>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -41,6 +46,10 @@ struct ObjectExport {
   Index serial_offset;
 
   std::shared_ptr<Object> object;
+
+  // Object is deserialized once, even if requested from several threads
+  std::unique_ptr<std::once_flag> exported =
+      std::make_unique<std::once_flag>();
 };
 
 struct GUID {
@@ -61,6 +70,12 @@ enum PackageFlags {
   PKG_Need = 0x8000,           // Client needs to download this package
 };
 
+// Parts of objects which are deserialized
+enum class LoadProfile {
+  Full,      // Everything, needed for rendering
+  Collision, // Only what geodata building uses, other payloads are skipped
+};
+
 struct PackageHeader {
   static constexpr std::int32_t PACKAGE_MAGIC = 0x9e2a83c1;
 
@@ -76,15 +91,35 @@ struct PackageHeader {
   std::vector<GenerationInfo> generations;
 };
 
+// Archive is immutable after it's opened. Objects are deserialized through
+// cursors, which are private to the thread exporting the object.
 class Archive : public utils::NonCopyable {
 private:
-  mutable NameTable m_name_table;
+  NameTable m_name_table;
 
 public:
+  // Binds a cursor over the archive data to the current thread until it's
+  // destroyed. Reads from the archive on this thread go through the cursor.
+  class Cursor : public utils::NonCopyable {
+  public:
+    explicit Cursor(const Archive &archive, std::size_t offset);
+    ~Cursor();
+
+  private:
+    friend class Archive;
+
+    const Archive &m_archive;
+    utils::ByteReader m_reader;
+    Cursor *m_previous;
+
+    inline static thread_local Cursor *current = nullptr;
+  };
+
   const ObjectLoader object_loader;
   const PropertyExtractor property_extractor;
 
   const Name name;
+  const LoadProfile load_profile;
 
   PackageHeader header;
 
@@ -92,22 +127,21 @@ public:
   mutable std::vector<ObjectImport> import_map;
   mutable std::vector<ObjectExport> export_map;
 
-  explicit Archive(const std::string &name, std::stringstream input,
+  explicit Archive(const std::string &name, std::string data,
                    const ArchiveLoader &archive_loader);
 
-  Archive(Archive &&other)
-      : object_loader{other.object_loader},
-        property_extractor{other.property_extractor}, name{std::move(
-                                                          other.name)},
-        header{std::move(other.header)}, name_map{std::move(other.name_map)},
-        import_map{std::move(other.import_map)},
-        export_map{std::move(other.export_map)}, m_input{std::move(
-                                                     other.m_input)} {}
-
-  operator std::istream &() { return m_input; }
+  operator utils::ByteReader &() { return reader(); }
 
   auto object_name(Index index) const -> Name;
 
+  // Top level package the object is imported from
+  auto package(const ObjectImport &object_import) const -> Name;
+
+  // Packages objects are imported from, without duplicates. If classes are
+  // given, only imports of these classes are taken into account.
+  auto imported_packages(const std::vector<std::string> &class_names = {}) const
+      -> std::vector<std::string>;
+
   auto operator>>(PackageHeader &header) -> Archive &;
   auto operator>>(GUID &guid) -> Archive &;
   auto operator>>(GenerationInfo &generation) -> Archive &;
@@ -135,25 +169,102 @@ public:
     return *this;
   }
 
+  // Skips serialized array of fixed size (bulk extractable) elements
+  template <typename T> void skip_array() {
+    static_assert(utils::BulkExtraction<T>::enabled);
+
+    Index size{};
+    *this >> size;
+
+    reader().skip(static_cast<std::ptrdiff_t>(size.value) * sizeof(T));
+  }
+
   template <typename T>
   void load_objects(const std::string &class_name,
                     std::vector<std::shared_ptr<T>> &objects) const {
 
-    for (auto &object_export : export_map) {
-      if (object_export.class_name == class_name) {
-        objects.push_back(std::dynamic_pointer_cast<T>(
-            object_loader.export_object(object_export)));
-      }
+    const auto exports = m_exports_by_class.find(class_name);
+
+    if (exports == m_exports_by_class.end()) {
+      return;
+    }
+
+    for (const auto export_index : exports->second) {
+      objects.push_back(std::dynamic_pointer_cast<T>(
+          object_loader.export_object(export_map[export_index])));
     }
   }
 
+  // Deserializes objects on the pool, order of objects is preserved
+  template <typename T>
+  void load_objects(const std::string &class_name,
+                    std::vector<std::shared_ptr<T>> &objects,
+                    utils::JobPool &job_pool) const {
+
+    const auto exports = m_exports_by_class.find(class_name);
+
+    if (exports == m_exports_by_class.end()) {
+      return;
+    }
+
+    const auto &indices = exports->second;
+    const auto offset = objects.size();
+    objects.resize(offset + indices.size());
+
+    utils::JobPool::Batch batch;
+
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      job_pool.submit(
+          [this, &objects, &indices, offset, i](std::size_t) {
+            objects[offset + i] = std::dynamic_pointer_cast<T>(
+                object_loader.export_object(export_map[indices[i]]));
+          },
+          batch);
+    }
+
+    job_pool.wait(batch);
+  }
+
+  // Returns nullptr if there is no such export
+  auto find_export(std::string_view object_name,
+                   std::string_view class_name) const -> ObjectExport *;
+
   void dump(int line_count = 32, int line_length = 16);
 
   friend auto operator<<(std::ostream &output, const Archive &archive)
       -> std::ostream &;
 
 private:
-  std::stringstream m_input;
+  struct ExportKey {
+    std::string_view object_name;
+    std::string_view class_name;
+
+    auto operator==(const ExportKey &other) const -> bool = default;
+  };
+
+  struct ExportKeyHash {
+    auto operator()(const ExportKey &key) const -> std::size_t {
+      const std::hash<std::string_view> hash;
+      return hash(key.object_name) ^ (hash(key.class_name) << 1);
+    }
+  };
+
+  std::string m_data;
+
+  // Used only while the archive is opened
+  utils::ByteReader m_input;
+
+  // Precomputed, name table isn't modified after the archive is opened
+  Name m_none_name;
+
+  // Indices into export_map, built when archive is opened
+  std::unordered_map<std::string_view, std::vector<std::size_t>>
+      m_exports_by_class;
+  std::unordered_map<ExportKey, std::size_t, ExportKeyHash> m_exports_by_name;
+
+  void index_exports();
+
+  auto reader() -> utils::ByteReader &;
 };
 
 } // namespace unreal
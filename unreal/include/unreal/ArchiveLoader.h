@@ -3,9 +3,16 @@
 #include "Archive.h"
 #include "NameTable.h"
 
+#include <utils/JobPool.h>
+
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -20,26 +27,65 @@ struct SearchConfig {
       : directory{directory}, extension{extension} {}
 };
 
+// Thread-safe, each archive is loaded once
 class ArchiveLoader {
 public:
   explicit ArchiveLoader(const std::filesystem::path &root_path,
-                         const std::vector<SearchConfig> &configs)
-      : m_root_path{root_path}, m_configs{configs} {}
+                         const std::vector<SearchConfig> &configs,
+                         LoadProfile load_profile = LoadProfile::Full)
+      : m_root_path{root_path}, m_configs{configs},
+        m_load_profile{load_profile},
+        m_prefetch_pool{std::max(std::thread::hardware_concurrency(), 1u)} {}
+
+  auto load_profile() const -> LoadProfile { return m_load_profile; }
 
   auto load_archive(const std::string &name) const -> Archive *;
 
+  // Path of the archive file, if it's found in one of search directories
+  auto find_archive(const std::string &name) const
+      -> std::optional<std::filesystem::path>;
+
+  // Loads archives on a background pool, so they are ready when objects are
+  // imported from them. Missing archives are skipped silently.
+  void prefetch_archives(const std::vector<std::string> &names) const;
+
+  // Invalidates all objects loaded from the archive. Must not be called while
+  // the archive is used by another thread. Doesn't wait for a prefetch of the
+  // archive, the prefetch job frees the archive when it's finished.
+  void unload_archive(const std::string &name) const;
+
 private:
   const std::filesystem::path m_root_path;
   const std::vector<SearchConfig> m_configs;
+  const LoadProfile m_load_profile;
+
+  struct CachedArchive {
+    std::once_flag loaded;
+    std::unique_ptr<Archive> archive; // nullptr if package can't be found
+    std::atomic<bool> unloaded{false};
+  };
+
+  // Shared with prefetch jobs, an unloaded archive lives until its job ends
+  mutable std::unordered_map<std::string, std::shared_ptr<CachedArchive>>
+      m_archives;
+  mutable std::mutex m_mutex;
+
+  // Declared last: pending jobs are finished before the cache is destroyed
+  mutable utils::JobPool m_prefetch_pool;
 
-  mutable std::unordered_map<std::string, Archive> m_archives;
+  auto cached_archive(const std::string &name) const
+      -> std::shared_ptr<CachedArchive>;
+  void load_cached_archive(const std::string &name,
+                           CachedArchive &cached_archive) const;
 
-  auto load_and_cache_archive(const std::string &name,
-                              const std::filesystem::path &path) const
-      -> Archive *;
+  auto find_and_load_archive(const std::string &name) const
+      -> std::unique_ptr<Archive>;
+  auto open_archive(const std::string &name,
+                    const std::filesystem::path &path) const
+      -> std::unique_ptr<Archive>;
 
   void dump_decrypted(const std::filesystem::path &path,
-                      const std::stringstream &decrypted) const;
+                      const std::string &decrypted) const;
 };
 
 } // namespace unreal
@@ -95,6 +95,7 @@ public:
   virtual auto set_property(const Property &) -> bool { return false; }
 
   auto full_name() const -> std::string;
+  auto package_name() const -> std::string;
 
   friend auto operator<<(std::ostream &output, const Object &object)
       -> std::ostream &;
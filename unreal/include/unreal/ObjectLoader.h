@@ -3,8 +3,10 @@
 #include "Index.h"
 
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -34,6 +36,18 @@ public:
 private:
   Archive &m_archive;
   const ArchiveLoader &m_archive_loader;
+
+  struct ResolvedImport {
+    const Archive *archive;
+    ObjectExport *object_export;
+  };
+
+  // Import index to foreign export (nullptr if import can't be resolved)
+  mutable std::unordered_map<std::int32_t, ResolvedImport> m_resolved_imports;
+  mutable std::mutex m_mutex;
+
+  auto resolve_import(Index index) const -> ResolvedImport;
+  void deserialize(ObjectExport &object_export) const;
 };
 
 } // namespace unreal
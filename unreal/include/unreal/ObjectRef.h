@@ -7,6 +7,7 @@
 #include <utils/Assert.h>
 #include <utils/Log.h>
 
+#include <atomic>
 #include <memory>
 
 namespace unreal {
@@ -22,6 +23,17 @@ class ObjectRef {
 public:
   ObjectRef() : m_index{}, m_object_loader{nullptr}, m_object{nullptr} {}
 
+  ObjectRef(const ObjectRef &other)
+      : m_index{other.m_index}, m_object_loader{other.m_object_loader},
+        m_object{other.m_object.load()} {}
+
+  auto operator=(const ObjectRef &other) -> ObjectRef & {
+    m_index = other.m_index;
+    m_object_loader = other.m_object_loader;
+    m_object.store(other.m_object.load());
+    return *this;
+  }
+
   auto operator->() const -> std::shared_ptr<T> { return load_object<T>(); }
   operator std::shared_ptr<T>() const { return load_object<T>(); }
   operator T &() const { return *load_object<T>(); }
@@ -53,23 +65,29 @@ private:
   Index m_index;
   const ObjectLoader *m_object_loader;
 
-  mutable std::shared_ptr<T> m_object;
+  // Resolved lazily, maps loaded in parallel may resolve the same reference
+  // of a shared package at once. The object loader returns the same object
+  // for an index, so concurrent stores are equal.
+  mutable std::atomic<std::shared_ptr<T>> m_object;
 
   template <typename U> auto load_object() const -> std::shared_ptr<U> {
     if (requirement == ObjectRefRequirement::Optional && m_index == 0) {
       return nullptr;
     }
 
-    if (m_object == nullptr) {
+    std::shared_ptr<T> object = m_object.load();
+
+    if (object == nullptr) {
       ASSERT(m_object_loader != nullptr, "Unreal",
              "Object loader must be initialized");
       ASSERT(m_index != 0, "Unreal", "Index can't be equal to zero");
 
-      m_object =
+      object =
           std::dynamic_pointer_cast<U>(m_object_loader->load_object(m_index));
+      m_object.store(object);
     }
 
-    return std::dynamic_pointer_cast<U>(m_object);
+    return std::dynamic_pointer_cast<U>(object);
   }
 };
 
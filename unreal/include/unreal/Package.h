@@ -21,8 +21,22 @@ public:
     m_archive.load_objects(class_name, objects);
   }
 
+  template <typename T>
+  void load_objects(const std::string &class_name,
+                    std::vector<std::shared_ptr<T>> &objects,
+                    utils::JobPool &job_pool) const {
+
+    m_archive.load_objects(class_name, objects, job_pool);
+  }
+
   auto name() const -> std::string { return std::string{m_archive.name}; }
 
+  auto imported_packages(const std::vector<std::string> &class_names = {}) const
+      -> std::vector<std::string> {
+
+    return m_archive.imported_packages(class_names);
+  }
+
   friend auto operator<<(std::ostream &output, const Package &package)
       -> std::ostream &;
 
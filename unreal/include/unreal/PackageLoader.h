@@ -13,11 +13,21 @@ namespace unreal {
 class PackageLoader {
 public:
   explicit PackageLoader(const std::filesystem::path &root_path,
-                         const std::vector<SearchConfig> &configs)
-      : m_archive_loader{root_path, configs} {}
+                         const std::vector<SearchConfig> &configs,
+                         LoadProfile load_profile = LoadProfile::Full)
+      : m_archive_loader{root_path, configs, load_profile} {}
 
   auto load_package(const std::string &name) const -> std::optional<Package>;
 
+  auto package_path(const std::string &name) const
+      -> std::optional<std::filesystem::path>;
+
+  // Starts loading packages in background, doesn't wait for them
+  void prefetch_packages(const std::vector<std::string> &names) const;
+
+  // Invalidates all objects loaded from the package
+  void unload_package(const std::string &name) const;
+
 private:
   ArchiveLoader m_archive_loader;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utils/ExtractionHelpers.h>
+
 #include <cstdint>
 
 namespace unreal {
@@ -95,3 +97,29 @@ struct Quat {
 };
 
 } // namespace unreal
+
+// Bulk array extraction
+template <>
+struct utils::BulkExtraction<unreal::Color>
+    : utils::BulkExtractable<std::uint8_t, 4> {};
+template <>
+struct utils::BulkExtraction<unreal::Vector>
+    : utils::BulkExtractable<float, 3> {};
+template <>
+struct utils::BulkExtraction<unreal::Plane>
+    : utils::BulkExtractable<float, 4> {};
+template <>
+struct utils::BulkExtraction<unreal::Rotator>
+    : utils::BulkExtractable<std::int32_t, 3> {};
+template <>
+struct utils::BulkExtraction<unreal::Sphere>
+    : utils::BulkExtractable<float, 4> {};
+template <>
+struct utils::BulkExtraction<unreal::Matrix>
+    : utils::BulkExtractable<float, 16> {};
+template <>
+struct utils::BulkExtraction<unreal::Coords>
+    : utils::BulkExtractable<float, 12> {};
+template <>
+struct utils::BulkExtraction<unreal::Quat>
+    : utils::BulkExtractable<float, 4> {};
@@ -72,6 +72,18 @@ struct StaticMeshIndexStream {
       -> Archive &;
 };
 
+} // namespace unreal
+
+// Bulk array extraction
+template <>
+struct utils::BulkExtraction<unreal::StaticMeshVertex>
+    : utils::BulkExtractable<float, 6> {};
+template <>
+struct utils::BulkExtraction<unreal::StaticMeshUV>
+    : utils::BulkExtractable<float, 2> {};
+
+namespace unreal {
+
 struct StaticMeshMaterial {
   ObjectRef<Material, ObjectRefRequirement::Optional> material;
   bool enable_collision;
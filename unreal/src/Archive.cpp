@@ -3,16 +3,21 @@
 #include <unreal/Archive.h>
 #include <unreal/ArchiveLoader.h>
 
+#include <algorithm>
+
 namespace unreal {
 
-Archive::Archive(const std::string &name, std::stringstream input,
+Archive::Archive(const std::string &name, std::string data,
                  const ArchiveLoader &archive_loader)
     : object_loader{*this, archive_loader}, property_extractor{*this},
-      name{m_name_table.name(name)}, m_input{std::move(input)} {
+      name{m_name_table.name(name)},
+      load_profile{archive_loader.load_profile()}, m_data{std::move(data)},
+      m_input{m_data.data(), m_data.size()},
+      m_none_name{m_name_table.none_name()} {
 
   *this >> header;
 
-  m_input.seekg(header.name_offset);
+  m_input.seek(header.name_offset);
   for (auto i = 0; i < header.name_count; ++i) {
     std::string name;
     std::uint32_t flags = 0;
@@ -20,19 +25,116 @@ Archive::Archive(const std::string &name, std::stringstream input,
     name_map.emplace_back(m_name_table.name(name));
   }
 
-  m_input.seekg(header.import_offset);
+  m_input.seek(header.import_offset);
   for (auto i = 0; i < header.import_count; ++i) {
     ObjectImport object_import{};
     *this >> object_import;
     import_map.push_back(object_import);
   }
 
-  m_input.seekg(header.export_offset);
+  m_input.seek(header.export_offset);
   for (auto i = 0; i < header.export_count; ++i) {
     ObjectExport object_export{};
     *this >> object_export;
     export_map.push_back(std::move(object_export));
   }
+
+  index_exports();
+}
+
+Archive::Cursor::Cursor(const Archive &archive, std::size_t offset)
+    : m_archive{archive},
+      m_reader{archive.m_data.data(), archive.m_data.size()},
+      m_previous{current} {
+
+  m_reader.seek(offset);
+  current = this;
+}
+
+Archive::Cursor::~Cursor() { current = m_previous; }
+
+auto Archive::reader() -> utils::ByteReader & {
+  // Nested exports (from this or other archives) stack their cursors
+  auto *cursor = Cursor::current;
+
+  if (cursor != nullptr && &cursor->m_archive == this) [[likely]] {
+    return cursor->m_reader;
+  }
+
+  return m_input;
+}
+
+void Archive::index_exports() {
+  for (std::size_t i = 0; i < export_map.size(); ++i) {
+    const auto &object_export = export_map[i];
+
+    m_exports_by_class[object_export.class_name].push_back(i);
+
+    // First export wins, same as the linear search did
+    if (object_export.class_name != "Package") {
+      m_exports_by_name.try_emplace(
+          ExportKey{object_export.object_name, object_export.class_name}, i);
+    }
+  }
+}
+
+auto Archive::find_export(std::string_view object_name,
+                          std::string_view class_name) const
+    -> ObjectExport * {
+
+  const auto object_export =
+      m_exports_by_name.find(ExportKey{object_name, class_name});
+
+  if (object_export == m_exports_by_name.end()) {
+    return nullptr;
+  }
+
+  return &export_map[object_export->second];
+}
+
+auto Archive::package(const ObjectImport &object_import) const -> Name {
+  ASSERT(object_import.package_index != 0, "Unreal",
+         "Package index can't be equal to zero");
+  const auto *package_import = &object_import;
+
+  do {
+    ASSERT(static_cast<std::size_t>(-package_import->package_index) <=
+               import_map.size(),
+           "Unreal", "Package index out of import_map bounds");
+    package_import = &import_map[-package_import->package_index - 1];
+  } while (package_import->package_index != 0);
+
+  return package_import->object_name;
+}
+
+auto Archive::imported_packages(
+    const std::vector<std::string> &class_names) const
+    -> std::vector<std::string> {
+
+  std::vector<std::string> packages;
+
+  for (const auto &object_import : import_map) {
+    // Classes are imported from native packages (Core, Engine, ...)
+    if (object_import.package_index == 0 ||
+        object_import.class_name == "Class") {
+      continue;
+    }
+
+    if (!class_names.empty() &&
+        std::find(class_names.begin(), class_names.end(),
+                  object_import.class_name) == class_names.end()) {
+      continue;
+    }
+
+    std::string package_name{package(object_import)};
+
+    if (std::find(packages.begin(), packages.end(), package_name) ==
+        packages.end()) {
+      packages.push_back(std::move(package_name));
+    }
+  }
+
+  return packages;
 }
 
 auto Archive::object_name(Index index) const -> Name {
@@ -48,7 +150,7 @@ auto Archive::object_name(Index index) const -> Name {
     return export_map[index - 1].object_name;
   }
 
-  return m_name_table.none_name();
+  return m_none_name;
 }
 
 auto Archive::operator>>(PackageHeader &header) -> Archive & {
@@ -93,13 +195,45 @@ auto Archive::operator>>(Name &name) -> Archive & {
   if (static_cast<std::size_t>(index) < name_map.size()) {
     name = name_map[index];
   } else {
-    name = m_name_table.none_name();
+    name = m_none_name;
   }
 
   return *this;
 }
 
 auto Archive::operator>>(Index &index) -> Archive & {
+  static constexpr std::size_t max_index_size = 5;
+
+  auto &input = reader();
+
+  // Fast path: whole index is in the buffer, decode it in place
+  if (input.remaining() >= max_index_size) {
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(input.data());
+    std::uint32_t value = bytes[0] & 0x3f;
+    std::size_t size = 1;
+
+    if ((bytes[0] & (1 << 6)) != 0) {
+      for (auto shift = 6; shift < 32; shift += 7) {
+        const auto byte = bytes[size++];
+        value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+
+        if ((byte & (1 << 7)) == 0) {
+          break;
+        }
+      }
+    }
+
+    input.skip(static_cast<std::ptrdiff_t>(size));
+
+    index.value = static_cast<std::int32_t>(value);
+
+    if ((bytes[0] & (1 << 7)) != 0) {
+      index.value = -index.value;
+    }
+
+    return *this;
+  }
+
   std::uint8_t byte = 0;
   *this >> byte;
 
@@ -152,12 +286,12 @@ auto Archive::operator>>(ObjectExport &object_export) -> Archive & {
 }
 
 auto Archive::operator>>(char &value) -> Archive & {
-  m_input >> value;
+  reader().read(&value, sizeof(value));
   return *this;
 }
 
 auto Archive::operator>>(float &value) -> Archive & {
-  m_input.read(reinterpret_cast<char *>(&value), sizeof(value));
+  reader().read(&value, sizeof(value));
   return *this;
 }
 
@@ -217,8 +351,8 @@ auto Archive::operator>>(std::uint64_t &value) -> Archive & {
 }
 
 void Archive::dump(int line_count, int line_length) {
-  std::istream &input = *this;
-  const auto offset = input.tellg();
+  auto &input = reader();
+  const auto offset = input.tell();
 
   std::cout << std::endl;
   std::cout << "Package: " << name << std::endl;
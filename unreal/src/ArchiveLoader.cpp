@@ -8,47 +8,119 @@
 namespace unreal {
 
 auto ArchiveLoader::load_archive(const std::string &name) const -> Archive * {
-  const auto pair = m_archives.find(name);
+  const auto archive = cached_archive(name);
+  load_cached_archive(name, *archive);
+  return archive->archive.get();
+}
 
-  if (pair != m_archives.end()) {
-    return &pair->second;
+void ArchiveLoader::prefetch_archives(
+    const std::vector<std::string> &names) const {
+
+  for (const auto &name : names) {
+    // Entry is taken now, so the job doesn't load the archive again if it's
+    // unloaded before the job starts
+    m_prefetch_pool.submit(
+        [this, name, archive = cached_archive(name)](std::size_t) {
+          if (!archive->unloaded && find_archive(name).has_value()) {
+            load_cached_archive(name, *archive);
+          }
+        });
   }
+}
 
-  utils::Log(utils::LOG_INFO, "Unreal")
-      << "Loading package: " << name << std::endl;
+auto ArchiveLoader::cached_archive(const std::string &name) const
+    -> std::shared_ptr<CachedArchive> {
+
+  std::lock_guard lock{m_mutex};
+  auto &entry = m_archives[name];
+
+  if (entry == nullptr) {
+    entry = std::make_shared<CachedArchive>();
+  }
+
+  return entry;
+}
+
+void ArchiveLoader::load_cached_archive(const std::string &name,
+                                        CachedArchive &cached_archive) const {
+
+  // Other packages can be loaded in parallel, threads requesting the same
+  // package wait for the first one
+  std::call_once(cached_archive.loaded, [this, &name, &cached_archive] {
+    cached_archive.archive = find_and_load_archive(name);
+  });
+}
+
+auto ArchiveLoader::find_archive(const std::string &name) const
+    -> std::optional<std::filesystem::path> {
 
   for (const auto &config : m_configs) {
     const auto path =
         m_root_path / config.directory / (name + "." + config.extension);
 
-    if (!std::filesystem::exists(path)) {
-      continue;
+    if (std::filesystem::exists(path)) {
+      return path;
+    }
+  }
+
+  return {};
+}
+
+auto ArchiveLoader::find_and_load_archive(const std::string &name) const
+    -> std::unique_ptr<Archive> {
+
+  utils::Log(utils::LOG_INFO, "Unreal")
+      << "Loading package: " << name << std::endl;
+
+  const auto path = find_archive(name);
+
+  if (!path.has_value()) {
+    utils::Log(utils::LOG_WARN, "Unreal")
+        << "Can't find package: " << name << std::endl;
+    return nullptr;
+  }
+
+  return open_archive(name, path.value());
+}
+
+void ArchiveLoader::unload_archive(const std::string &name) const {
+  std::shared_ptr<CachedArchive> archive;
+
+  {
+    std::lock_guard lock{m_mutex};
+    const auto entry = m_archives.find(name);
+
+    if (entry == m_archives.end()) {
+      return;
     }
 
-    return load_and_cache_archive(name, path);
+    archive = std::move(entry->second);
+    m_archives.erase(entry);
   }
 
-  utils::Log(utils::LOG_WARN, "Unreal")
-      << "Can't find package: " << name << std::endl;
+  // Archive may be still loading on the prefetch pool, its job keeps the
+  // archive alive until it's finished. Jobs not started yet skip it.
+  archive->unloaded = true;
 
-  return nullptr;
+  utils::Log(utils::LOG_INFO, "Unreal")
+      << "Package unloaded: " << name << std::endl;
 }
 
-auto ArchiveLoader::load_and_cache_archive(
-    const std::string &name, const std::filesystem::path &path) const
-    -> Archive * {
+auto ArchiveLoader::open_archive(const std::string &name,
+                                 const std::filesystem::path &path) const
+    -> std::unique_ptr<Archive> {
 
-  std::stringstream decrypted;
-  const Decryptor decryptor;
+  std::string decrypted;
+  // Chunks of large packages are decrypted on the prefetch pool, also when
+  // the package itself is prefetched
+  const Decryptor decryptor{&m_prefetch_pool};
   decryptor.decrypt(path, decrypted);
 
   if (utils::Log::level > utils::LOG_INFO) {
     dump_decrypted(path, decrypted);
   }
 
-  const auto inserted =
-      m_archives.try_emplace(name, name, std::move(decrypted), *this);
-  auto *archive = &inserted.first->second;
+  auto archive = std::make_unique<Archive>(name, std::move(decrypted), *this);
 
   utils::Log(utils::LOG_INFO, "Unreal")
       << "Package loaded: " << name
@@ -59,7 +131,7 @@ auto ArchiveLoader::load_and_cache_archive(
 }
 
 void ArchiveLoader::dump_decrypted(const std::filesystem::path &path,
-                                   const std::stringstream &decrypted) const {
+                                   const std::string &decrypted) const {
 
   auto output_path = path.filename();
   output_path += ".dec";
@@ -68,7 +140,7 @@ void ArchiveLoader::dump_decrypted(const std::filesystem::path &path,
   utils::Log(utils::LOG_DEBUG, "Unreal")
       << "Decrypted package: " << output_path << std::endl;
 
-  output << decrypted.str();
+  output << decrypted;
 }
 
 } // namespace unreal
@@ -10,15 +10,27 @@ void Primitive::deserialize() {
 }
 
 auto operator>>(Archive &archive, BSPNode &node) -> Archive & {
+  auto &input = static_cast<utils::ByteReader &>(archive);
+
   archive >> node.plane >> node.zone_mask >> node.flags >>
       node.vertex_pool_index >> node.surface_index >> node.back_index >>
       node.front_index >> node.plane_index >> node.collision_bound >>
-      node.render_bound >> node.unknown_point >> node.unknown_id >>
-      node.connectivity >> node.visibility >> node.zone[0] >> node.zone[1] >>
-      node.vertex_count >> node.leaf[0] >> node.leaf[1];
+      node.render_bound;
+
+  if (archive.load_profile == LoadProfile::Full) {
+    archive >> node.unknown_point >> node.unknown_id >> node.connectivity >>
+        node.visibility;
+  } else {
+    // Rendering and zone visibility data (unknown_point, unknown_id,
+    // connectivity, visibility)
+    input.skip(12 + 4 + 8 + 8);
+  }
+
+  archive >> node.zone[0] >> node.zone[1] >> node.vertex_count >>
+      node.leaf[0] >> node.leaf[1];
 
   // Skip 4 pointers (4*4 bytes) to projected textures
-  static_cast<std::istream &>(archive).seekg(12, std::ios::cur);
+  input.skip(12);
 
   return archive;
 }
@@ -2,21 +2,149 @@
 
 #include "Decryptor.h"
 
+#include <utils/MappedFile.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DECRYPTOR_SSE2
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||           \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define DECRYPTOR_AVX2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// MSVC emits any intrinsic, GCC and Clang need the target enabled per function
+#if defined(__GNUC__) || defined(__clang__)
+#define DECRYPTOR_TARGET(feature) __attribute__((target(feature)))
+#else
+#define DECRYPTOR_TARGET(feature)
+#endif
+
 namespace unreal {
 
-static constexpr std::streamsize LINEAGE_SIZE = 22;
-static constexpr std::streamsize VERSION_SIZE = 6;
+static constexpr std::size_t LINEAGE_SIZE = 22;
+static constexpr std::size_t VERSION_SIZE = 6;
+
+// Packages larger than one chunk are decrypted in parallel
+static constexpr std::size_t CHUNK_SIZE = 8 * 1024 * 1024;
 
 // "Lineage2Ver" string
 static constexpr std::array<char, LINEAGE_SIZE> LINEAGE_HEADER = {
     0x4c, 0x00, 0x69, 0x00, 0x6e, 0x00, 0x65, 0x00, 0x61, 0x00, 0x67,
     0x00, 0x65, 0x00, 0x32, 0x00, 0x56, 0x00, 0x65, 0x00, 0x72, 0x00};
 
+#ifdef DECRYPTOR_AVX2
+#ifdef _MSC_VER
+// __builtin_cpu_supports needs the compiler runtime, which isn't linked with
+// the MSVC toolchain. AVX2 also needs the OS to save the YMM registers.
+DECRYPTOR_TARGET("xsave") static auto cpu_supports_avx2() -> bool {
+  std::array<int, 4> info{};
+
+  __cpuid(info.data(), 0);
+
+  if (info[0] < 7) {
+    return false;
+  }
+
+  __cpuid(info.data(), 1);
+
+  const auto osxsave = (info[2] & (1 << 27)) != 0;
+  const auto avx = (info[2] & (1 << 28)) != 0;
+
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+
+  __cpuidex(info.data(), 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+}
+#else
+static auto cpu_supports_avx2() -> bool {
+  return __builtin_cpu_supports("avx2") != 0;
+}
+#endif
+
+DECRYPTOR_TARGET("avx2")
+static auto xor_avx2(const unsigned char *input, unsigned char *output, std::size_t size,
+         std::uint8_t key) -> std::size_t {
+
+  const auto mask = _mm256_set1_epi8(static_cast<char>(key));
+  std::size_t i = 0;
+
+  for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+    const auto block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i),
+                        _mm256_xor_si256(block, mask));
+  }
+
+  return i;
+}
+#endif
+
+#ifdef DECRYPTOR_SSE2
+static auto xor_sse2(const unsigned char *input, unsigned char *output,
+                     std::size_t size, std::uint8_t key) -> std::size_t {
+
+  const auto mask = _mm_set1_epi8(static_cast<char>(key));
+  std::size_t i = 0;
+
+  for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+    const auto block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i),
+                     _mm_xor_si128(block, mask));
+  }
+
+  return i;
+}
+#endif
+
+static void xor_block(const unsigned char *input, unsigned char *output,
+                      std::size_t size, std::uint8_t key) {
+
+  std::size_t i = 0;
+
+#ifdef DECRYPTOR_AVX2
+  static const auto has_avx2 = cpu_supports_avx2();
+
+  if (has_avx2) {
+    i += xor_avx2(input, output, size, key);
+  }
+#endif
+
+#ifdef DECRYPTOR_SSE2
+  i += xor_sse2(input + i, output + i, size - i, key);
+#endif
+
+  for (; i < size; ++i) {
+    output[i] = input[i] ^ key;
+  }
+}
+
 void Decryptor::decrypt(const std::filesystem::path &path,
-                        std::ostream &output) const {
+                        std::string &output) const {
 
-  std::ifstream input{path, std::ios::binary};
-  const auto version = extract_version(input);
+  output.clear();
+
+  const utils::MappedFile file{path};
+
+  if (!file.valid()) {
+    ASSERT(false, "Unreal", "Can't read package: " << path);
+    return;
+  }
+
+  const auto version = extract_version(file.data(), file.size());
 
   if (!version.has_value()) {
     ASSERT(false, "Unreal", "Can't detect Lineage 2 encryption version");
@@ -25,12 +153,15 @@ void Decryptor::decrypt(const std::filesystem::path &path,
     return;
   }
 
+  const auto *input = file.data() + LINEAGE_SIZE + VERSION_SIZE;
+  const auto size = file.size() - LINEAGE_SIZE - VERSION_SIZE;
+
   switch (version.value()) {
   case 111: {
-    decrypt_v111(input, output);
+    decrypt_v111(input, size, output);
   } break;
   case 121: {
-    decrypt_v121(input, output, path);
+    decrypt_v121(input, size, output, path);
   } break;
   default: {
     ASSERT(false, "Unreal",
@@ -39,22 +170,20 @@ void Decryptor::decrypt(const std::filesystem::path &path,
   }
 }
 
-auto Decryptor::extract_version(std::istream &input) const
-    -> std::optional<int> {
+auto Decryptor::extract_version(const unsigned char *data,
+                                std::size_t size) const -> std::optional<int> {
 
-  std::array<char, LINEAGE_SIZE> lineage_buffer{};
-  std::array<char, VERSION_SIZE> version_buffer{};
-  input.read(lineage_buffer.data(), LINEAGE_SIZE);
-  input.read(version_buffer.data(), VERSION_SIZE);
-
-  if (lineage_buffer != LINEAGE_HEADER) {
+  if (size < LINEAGE_SIZE + VERSION_SIZE ||
+      !std::equal(LINEAGE_HEADER.begin(), LINEAGE_HEADER.end(), data)) {
     return {};
   }
 
+  const auto *version_buffer = data + LINEAGE_SIZE;
+
   std::string version_string;
-  version_string += version_buffer[0];
-  version_string += version_buffer[2];
-  version_string += version_buffer[4];
+  version_string += static_cast<char>(version_buffer[0]);
+  version_string += static_cast<char>(version_buffer[2]);
+  version_string += static_cast<char>(version_buffer[4]);
 
   std::istringstream version_stream(version_string);
   auto version = 0;
@@ -63,23 +192,70 @@ auto Decryptor::extract_version(std::istream &input) const
   return version;
 }
 
-void Decryptor::decrypt_xor(std::istream &input, std::ostream &output,
-                            int key) const {
+void Decryptor::decrypt_xor(const unsigned char *input, std::size_t size,
+                            std::string &output, std::uint8_t key) const {
 
-  std::istreambuf_iterator input_iterator{input};
-  std::ostreambuf_iterator output_iterator{output};
-  std::istreambuf_iterator<char> end;
+  output.resize(size);
+  auto *decrypted = reinterpret_cast<unsigned char *>(output.data());
 
-  for (auto it = input_iterator; it != end; ++it) {
-    *(output_iterator++) = *it ^ key;
+  // Key doesn't depend on position, so chunks are independent
+  const auto chunk_count = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  if (m_job_pool == nullptr || chunk_count <= 1) {
+    xor_block(input, decrypted, size, key);
+    return;
+  }
+
+  // The calling thread decrypts chunks too and waits only for chunks taken by
+  // the helpers, so it doesn't block on a busy pool (or on its own job, if it
+  // runs on the pool). Helpers started late find no chunks left, the state
+  // outlives this call for them.
+  struct Chunks {
+    std::atomic<std::size_t> next = 0;
+    std::atomic<std::size_t> finished = 0;
+  };
+
+  const auto chunks = std::make_shared<Chunks>();
+
+  const auto decrypt_chunks = [input, decrypted, size, key, chunk_count,
+                               chunks] {
+    for (auto chunk = chunks->next++; chunk < chunk_count;
+         chunk = chunks->next++) {
+
+      const auto offset = chunk * CHUNK_SIZE;
+      xor_block(input + offset, decrypted + offset,
+                std::min(CHUNK_SIZE, size - offset), key);
+
+      if (++chunks->finished == chunk_count) {
+        chunks->finished.notify_all();
+      }
+    }
+  };
+
+  const auto helper_count =
+      std::min(chunk_count, m_job_pool->thread_count()) - 1;
+
+  for (std::size_t i = 0; i < helper_count; ++i) {
+    m_job_pool->submit([decrypt_chunks](std::size_t) { decrypt_chunks(); });
+  }
+
+  decrypt_chunks();
+
+  for (auto finished = chunks->finished.load(); finished < chunk_count;
+       finished = chunks->finished.load()) {
+
+    chunks->finished.wait(finished);
   }
 }
 
-void Decryptor::decrypt_v111(std::istream &input, std::ostream &output) const {
-  decrypt_xor(input, output, 0xac);
+void Decryptor::decrypt_v111(const unsigned char *input, std::size_t size,
+                             std::string &output) const {
+
+  decrypt_xor(input, size, output, 0xac);
 }
 
-void Decryptor::decrypt_v121(std::istream &input, std::ostream &output,
+void Decryptor::decrypt_v121(const unsigned char *input, std::size_t size,
+                             std::string &output,
                              const std::filesystem::path &path) const {
 
   const auto filename = path.filename().string();
@@ -89,7 +265,7 @@ void Decryptor::decrypt_v121(std::istream &input, std::ostream &output,
     key += std::tolower(character);
   }
 
-  decrypt_xor(input, output, key);
+  decrypt_xor(input, size, output, static_cast<std::uint8_t>(key));
 }
 
 } // namespace unreal
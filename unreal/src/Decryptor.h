@@ -1,20 +1,36 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
-#include <iostream>
 #include <optional>
+#include <string>
+
+#include <utils/JobPool.h>
 
 namespace unreal {
 
 class Decryptor {
 public:
-  void decrypt(const std::filesystem::path &path, std::ostream &output) const;
+  // Packages larger than one chunk are decrypted in parallel on the pool, if
+  // it's passed. Decryption may run on a thread of the same pool.
+  explicit Decryptor(utils::JobPool *job_pool = nullptr)
+      : m_job_pool{job_pool} {}
+
+  // Output is left empty if the package can't be decrypted
+  void decrypt(const std::filesystem::path &path, std::string &output) const;
 
 private:
-  auto extract_version(std::istream &input) const -> std::optional<int>;
-  void decrypt_xor(std::istream &input, std::ostream &output, int key) const;
-  void decrypt_v111(std::istream &input, std::ostream &output) const;
-  void decrypt_v121(std::istream &input, std::ostream &output,
+  utils::JobPool *m_job_pool;
+
+  auto extract_version(const unsigned char *data, std::size_t size) const
+      -> std::optional<int>;
+  void decrypt_xor(const unsigned char *input, std::size_t size,
+                   std::string &output, std::uint8_t key) const;
+  void decrypt_v111(const unsigned char *input, std::size_t size,
+                    std::string &output) const;
+  void decrypt_v121(const unsigned char *input, std::size_t size,
+                    std::string &output,
                     const std::filesystem::path &path) const;
 };
 
@@ -48,7 +48,7 @@ void Level::deserialize() {
   // Why 2 bytes? In UE bool = 4 bytes (dword), but it doesn't work, so I
   // read only 1 byte for bool (url.valid field) and next 2 bytes of something
   // unknown.
-  static_cast<std::istream &>(archive).seekg(2, std::ios::cur);
+  static_cast<utils::ByteReader &>(archive).skip(2);
 
   archive >> reach_specs >> model;
 }
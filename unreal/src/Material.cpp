@@ -140,6 +140,11 @@ void Texture::deserialize() {
   MaterialDeserializer deserializer{};
   deserializer.deserialize(archive);
 
+  // Only terrain heightmaps are used by geodata, mips are the last
+  if (archive.load_profile == LoadProfile::Collision && format != TEXF_G16) {
+    return;
+  }
+
   if (format != TEXF_DXT1 &&  //
       format != TEXF_DXT3 &&  //
       format != TEXF_DXT5 &&  //
@@ -178,7 +183,7 @@ void Texture::deserialize() {
   while (size != exprected_size) {
     archive >> size;
 
-    if (static_cast<std::istream &>(archive).eof()) {
+    if (static_cast<utils::ByteReader &>(archive).eof()) {
       ASSERT(false, "Unreal", "Unexpected EOF while deserializing texture");
       return;
     }
@@ -188,10 +193,9 @@ void Texture::deserialize() {
   mip.u_size = u_size;
   mip.v_size = v_size;
 
-  for (auto i = 0; i < size; ++i) {
-    std::uint8_t byte;
-    archive >> byte;
-    mip.data.push_back(byte);
+  if (size > 0) {
+    mip.data.resize(size);
+    utils::read_bytes(archive, mip.data.data(), mip.data.size());
   }
 
   mips.push_back(mip);
@@ -23,7 +23,11 @@ void Object::deserialize() {
 }
 
 auto Object::full_name() const -> std::string {
-  return std::string{archive.name} + "." + std::string{name};
+  return package_name() + "." + std::string{name};
+}
+
+auto Object::package_name() const -> std::string {
+  return std::string{archive.name};
 }
 
 auto operator>>(Archive &archive, StateFrame &state_frame) -> Archive & {
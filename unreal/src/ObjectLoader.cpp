@@ -15,48 +15,31 @@ namespace unreal {
 auto ObjectLoader::load_object(const ObjectImport &import) const
     -> std::shared_ptr<Object> {
 
-  for (auto &object_export : m_archive.export_map) {
-    if (object_export.object_name == import.object_name &&
-        object_export.class_name == import.class_name &&
-        object_export.class_name != "Package") {
+  auto *object_export =
+      m_archive.find_export(import.object_name, import.class_name);
 
-      return export_object(object_export);
-    }
+  if (object_export == nullptr) {
+    utils::Log(utils::LOG_WARN, "Unreal")
+        << "Can't find object: " << import.object_name << std::endl;
+    return nullptr;
   }
 
-  utils::Log(utils::LOG_WARN, "Unreal")
-      << "Can't find object: " << import.object_name << std::endl;
-  return nullptr;
+  return export_object(*object_export);
 }
 
 auto ObjectLoader::load_object(Index index) const -> std::shared_ptr<Object> {
   ASSERT(index != 0, "Unreal", "Index can't be equal to zero");
 
   if (index < 0) {
-    ASSERT(static_cast<std::size_t>(-index) <= m_archive.import_map.size(),
-           "Unreal", "Index out of import_map bounds");
-    const auto &import = m_archive.import_map[-index - 1];
-
-    ASSERT(import.package_index != 0, "Unreal",
-           "Package index can't be equal to zero");
-    const auto *package_import = &import;
-
-    do {
-      ASSERT(static_cast<std::size_t>(-package_import->package_index) <=
-                 m_archive.import_map.size(),
-             "Unreal", "Package index out of import_map bounds");
-      package_import =
-          &m_archive.import_map[-package_import->package_index - 1];
-    } while (package_import->package_index != 0);
-
-    const auto *archive =
-        m_archive_loader.load_archive(std::string{package_import->object_name});
-
-    if (archive == nullptr) {
+    const auto resolved_import = resolve_import(index);
+
+    if (resolved_import.object_export == nullptr) {
       return nullptr;
     }
 
-    return archive->object_loader.load_object(import);
+    // Object is deserialized from the archive it belongs to
+    return resolved_import.archive->object_loader.export_object(
+        *resolved_import.object_export);
   }
 
   if (index > 0) {
@@ -69,13 +52,52 @@ auto ObjectLoader::load_object(Index index) const -> std::shared_ptr<Object> {
   return nullptr;
 }
 
+auto ObjectLoader::resolve_import(Index index) const -> ResolvedImport {
+  {
+    std::lock_guard lock{m_mutex};
+    const auto resolved_import = m_resolved_imports.find(index);
+
+    if (resolved_import != m_resolved_imports.end()) {
+      return resolved_import->second;
+    }
+  }
+
+  ASSERT(static_cast<std::size_t>(-index) <= m_archive.import_map.size(),
+         "Unreal", "Index out of import_map bounds");
+  const auto &import = m_archive.import_map[-index - 1];
+
+  const auto *archive =
+      m_archive_loader.load_archive(std::string{m_archive.package(import)});
+
+  ObjectExport *object_export = nullptr;
+
+  if (archive != nullptr) {
+    object_export = archive->find_export(import.object_name, import.class_name);
+
+    if (object_export == nullptr) {
+      utils::Log(utils::LOG_WARN, "Unreal")
+          << "Can't find object: " << import.object_name << std::endl;
+    }
+  }
+
+  // Lock isn't held while the archive is loaded, another thread may have
+  // resolved the same import in the meantime
+  std::lock_guard lock{m_mutex};
+  return m_resolved_imports
+      .try_emplace(index, ResolvedImport{archive, object_export})
+      .first->second;
+}
+
 auto ObjectLoader::export_object(ObjectExport &object_export) const
     -> std::shared_ptr<Object> {
 
-  if (object_export.object != nullptr) {
-    return object_export.object;
-  }
+  std::call_once(*object_export.exported,
+                 [this, &object_export] { deserialize(object_export); });
 
+  return object_export.object;
+}
+
+void ObjectLoader::deserialize(ObjectExport &object_export) const {
   std::shared_ptr<Object> object;
 
   if (object_export.class_name == "Model") {
@@ -122,15 +144,12 @@ auto ObjectLoader::export_object(ObjectExport &object_export) const
   object->name = object_export.object_name;
   object->flags = object_export.object_flags;
 
-  if (object_export.serial_size > 0) {
-    static_cast<std::istream &>(m_archive).seekg(
-        object_export.serial_offset.value);
-  }
+  const Archive::Cursor cursor{
+      m_archive, static_cast<std::size_t>(object_export.serial_offset.value)};
 
   object->deserialize();
 
   object_export.object = object;
-  return object_export.object;
 }
 
 } // namespace unreal
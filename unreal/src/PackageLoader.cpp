@@ -16,4 +16,20 @@ auto PackageLoader::load_package(const std::string &name) const
   return Package{*archive};
 }
 
+auto PackageLoader::package_path(const std::string &name) const
+    -> std::optional<std::filesystem::path> {
+
+  return m_archive_loader.find_archive(name);
+}
+
+void PackageLoader::prefetch_packages(
+    const std::vector<std::string> &names) const {
+
+  m_archive_loader.prefetch_archives(names);
+}
+
+void PackageLoader::unload_package(const std::string &name) const {
+  m_archive_loader.unload_archive(name);
+}
+
 } // namespace unreal
@@ -46,7 +46,7 @@ void PropertyExtractor::deserialize(Property &property) const {
     m_archive >> property.array_index;
   }
 
-  std::istream &input = m_archive;
+  utils::ByteReader &input = m_archive;
 
   switch (property.type) {
   case PropertyType::Byte: {
@@ -63,26 +63,25 @@ void PropertyExtractor::deserialize(Property &property) const {
     m_archive >> property.index_value;
   } break;
   case PropertyType::Array: {
-    const auto start_position = input.tellg();
+    const auto start_position = input.tell();
     m_archive >> property.array_size;
-    const auto size_size = input.tellg() - start_position;
+    const auto size_size = input.tell() - start_position;
     const auto array_size = property.size - size_size;
 
     if (property.name == "Materials") {
       property.subproperties.reserve(property.array_size);
-      const auto array_start_position = input.tellg();
+      const auto array_start_position = input.tell();
 
       for (auto i = 0; i < property.array_size; ++i) {
         property.subproperties.push_back(extract_properties_map());
       }
 
-      const auto array_end_position = input.tellg();
+      const auto array_end_position = input.tell();
       ASSERT((array_end_position - array_start_position) == array_size,
              "Unreal", "Invalid property array");
     } else {
       property.data_value.resize(array_size);
-      input.read(reinterpret_cast<char *>(property.data_value.data()),
-                 array_size);
+      input.read(property.data_value.data(), array_size);
     }
   } break;
   case PropertyType::Struct: {
@@ -95,7 +94,7 @@ void PropertyExtractor::deserialize(Property &property) const {
     } else {
       utils::Log(utils::LOG_DEBUG, "Unreal")
           << "Skipping struct: " << property.struct_name << std::endl;
-      input.seekg(property.size, std::ios::cur);
+      input.skip(property.size);
     }
   } break;
   case PropertyType::Vector: {
@@ -108,7 +107,7 @@ void PropertyExtractor::deserialize(Property &property) const {
     utils::Log(utils::LOG_DEBUG, "Unreal")
         << "Skipping property type: " << static_cast<int>(property.type)
         << std::endl;
-    input.seekg(property.size, std::ios::cur);
+    input.skip(property.size);
   }
   }
 }
@@ -44,9 +44,33 @@ auto operator>>(Archive &archive, StaticMeshIndexStream &stream) -> Archive & {
 void StaticMesh::deserialize() {
   Primitive::deserialize();
 
-  archive >> surfaces >> bounding_box >> vertex_stream >> color_stream >>
-      alpha_stream >> uv_stream >> index_stream >> wireframe_index_stream >>
-      collision_model;
+  archive >> surfaces >> bounding_box >> vertex_stream;
+
+  if (archive.load_profile == LoadProfile::Full) {
+    archive >> color_stream >> alpha_stream >> uv_stream >> index_stream >>
+        wireframe_index_stream >> collision_model;
+    return;
+  }
+
+  auto &input = static_cast<utils::ByteReader &>(archive);
+
+  // Color and alpha streams
+  for (auto i = 0; i < 2; ++i) {
+    archive.skip_array<Color>();
+    input.skip(sizeof(std::uint32_t)); // revision
+  }
+
+  // UV streams
+  Index uv_stream_count{};
+  archive >> uv_stream_count;
+
+  for (auto i = 0; i < uv_stream_count.value; ++i) {
+    archive.skip_array<StaticMeshUV>();
+    input.skip(2 * sizeof(std::uint32_t)); // coordinate_index, revision
+  }
+
+  // Wireframe indices and collision model aren't needed, they are the last
+  archive >> index_stream;
 }
 
 auto StaticMesh::set_property(const Property &property) -> bool {
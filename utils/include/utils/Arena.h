@@ -0,0 +1,70 @@
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace utils {
+
+// Chunked bump allocator for memory that lives as long as one task, e.g. a
+// map build. Small deallocations are no-ops, large blocks are recycled by
+// size. reset() makes all memory available again in O(1) and keeps the chunks
+// for the next task, so repeated tasks don't go back to the heap. Thread-safe.
+class Arena : public std::pmr::memory_resource, public NonCopyable {
+public:
+  explicit Arena(std::size_t chunk_size = 64 * 1024 * 1024);
+  ~Arena() override;
+
+  // Memory allocated before becomes invalid
+  void reset();
+
+  // Bytes held in chunks
+  auto capacity() const -> std::size_t;
+
+  // Arena of the current thread for code that can't take a memory resource
+  // (e.g. Recast allocation hooks), nullptr if none
+  static auto current() -> Arena *;
+
+  // Makes the arena current on this thread until the end of the scope
+  class Scope : public NonCopyable {
+  public:
+    explicit Scope(Arena &arena);
+    ~Scope();
+
+  private:
+    Arena *m_previous;
+  };
+
+private:
+  static constexpr std::size_t LARGE_BLOCK_SIZE = 1024 * 1024;
+
+  struct Chunk {
+    std::byte *data;
+    std::size_t size;
+  };
+
+  struct Block {
+    void *data;
+    std::size_t size;
+    std::size_t alignment;
+  };
+
+  const std::size_t m_chunk_size;
+
+  mutable std::mutex m_mutex;
+  std::vector<Chunk> m_chunks;
+  std::size_t m_chunk;  // Chunk allocations are taken from
+  std::size_t m_offset; // First free byte in it
+  std::vector<Block> m_free_blocks;
+
+  auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override;
+  void do_deallocate(void *pointer, std::size_t bytes,
+                     std::size_t alignment) override;
+  auto do_is_equal(const std::pmr::memory_resource &other) const noexcept
+      -> bool override;
+};
+
+} // namespace utils
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+namespace utils {
+
+// Cursor over a contiguous block of memory. Doesn't own the data.
+// Like std::istream, reading past the end sets the EOF flag, missing bytes
+// are filled with zeros.
+class ByteReader {
+public:
+  explicit ByteReader() : ByteReader{nullptr, 0} {}
+
+  explicit ByteReader(const char *data, std::size_t size)
+      : m_begin{data}, m_end{data + size}, m_cursor{data}, m_eof{false} {}
+
+  auto size() const -> std::size_t {
+    return static_cast<std::size_t>(m_end - m_begin);
+  }
+
+  auto tell() const -> std::size_t {
+    return static_cast<std::size_t>(m_cursor - m_begin);
+  }
+
+  auto remaining() const -> std::size_t {
+    return static_cast<std::size_t>(m_end - m_cursor);
+  }
+
+  auto eof() const -> bool { return m_eof; }
+
+  // Current position
+  auto data() const -> const char * { return m_cursor; }
+
+  void seek(std::size_t offset) {
+    m_eof = offset > size();
+    m_cursor = m_eof ? m_end : m_begin + offset;
+  }
+
+  void skip(std::ptrdiff_t count) {
+    const auto offset = static_cast<std::ptrdiff_t>(tell()) + count;
+    seek(offset < 0 ? 0 : static_cast<std::size_t>(offset));
+  }
+
+  void read(void *output, std::size_t count) {
+    if (count <= remaining()) [[likely]] {
+      std::memcpy(output, m_cursor, count);
+      m_cursor += count;
+      return;
+    }
+
+    const auto available = remaining();
+
+    if (available > 0) {
+      std::memcpy(output, m_cursor, available);
+    }
+
+    std::memset(static_cast<char *>(output) + available, 0, count - available);
+
+    m_cursor = m_end;
+    m_eof = true;
+  }
+
+private:
+  const char *m_begin;
+  const char *m_end;
+  const char *m_cursor;
+  bool m_eof;
+};
+
+} // namespace utils
@@ -1,14 +1,75 @@
 #pragma once
 
 #include "Assert.h"
+#include "ByteReader.h"
 
 #include <llvm/Endian.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <istream>
+#include <type_traits>
 
 namespace utils {
 
+// Records serialized exactly as their in-memory representation: `count`
+// little-endian `ScalarT` values without padding. Arrays of such records are
+// extracted with a single copy.
+template <typename ScalarT, std::size_t count = 1> struct BulkExtractable {
+  static constexpr auto enabled = true;
+  static constexpr auto scalar_count = count;
+  using scalar_type = ScalarT;
+};
+
+// Specialize for types that can be extracted in bulk
+template <typename T, typename = void> struct BulkExtraction {
+  static constexpr auto enabled = false;
+};
+
+template <typename T>
+struct BulkExtraction<
+    T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+    : BulkExtractable<T> {};
+
+// Converts little-endian scalars to the host byte order in place
+template <typename T> void bulk_to_host(T *values, std::size_t size) {
+  using ScalarT = typename BulkExtraction<T>::scalar_type;
+
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(sizeof(T) ==
+                sizeof(ScalarT) * BulkExtraction<T>::scalar_count);
+
+  if constexpr (llvm::sys::IsBigEndianHost && sizeof(ScalarT) > 1) {
+    auto *bytes = reinterpret_cast<unsigned char *>(values);
+    const auto scalar_count = size * BulkExtraction<T>::scalar_count;
+
+    for (std::size_t i = 0; i < scalar_count; ++i) {
+      ScalarT scalar{};
+      std::memcpy(&scalar, bytes + i * sizeof(ScalarT), sizeof(ScalarT));
+      scalar = llvm::sys::getSwappedBytes(scalar);
+      std::memcpy(bytes + i * sizeof(ScalarT), &scalar, sizeof(ScalarT));
+    }
+  } else {
+    (void)values;
+    (void)size;
+  }
+}
+
+// Raw bytes extraction
+inline void read_bytes(std::istream &input_stream, void *output,
+                       std::size_t size) {
+
+  input_stream.read(static_cast<char *>(output),
+                    static_cast<std::streamsize>(size));
+}
+
+inline void read_bytes(ByteReader &input_stream, void *output,
+                       std::size_t size) {
+
+  input_stream.read(output, size);
+}
+
 // std::istream packed_endian_specific_integral extraction
 template <typename value_type, llvm::endianness endian, llvm::alignment align>
 auto operator>>(
@@ -16,8 +77,18 @@ auto operator>>(
     llvm::detail::packed_endian_specific_integral<value_type, endian, align>
         &integral) -> std::istream & {
 
-  input_stream.read(reinterpret_cast<char *>(integral.value),
-                    sizeof(integral.value));
+  read_bytes(input_stream, integral.value, sizeof(integral.value));
+  return input_stream;
+}
+
+// utils::ByteReader packed_endian_specific_integral extraction
+template <typename value_type, llvm::endianness endian, llvm::alignment align>
+auto operator>>(
+    ByteReader &input_stream,
+    llvm::detail::packed_endian_specific_integral<value_type, endian, align>
+        &integral) -> ByteReader & {
+
+  read_bytes(input_stream, integral.value, sizeof(integral.value));
   return input_stream;
 }
 
@@ -55,6 +126,23 @@ struct ExtractArrayHelper {
     const std::int32_t size = size_value;
 
     ASSERT(size >= 0, "Utils", "Size can't be negative: " << size);
+
+    using ElementT = typename StoreToT::value_type;
+
+    if constexpr (BulkExtraction<ExtractElementAsT>::enabled &&
+                  std::is_same_v<ExtractElementAsT, ElementT>) {
+      if (size > 0) {
+        const auto offset = store_to.size();
+        store_to.resize(offset + size);
+
+        read_bytes(input_stream, store_to.data() + offset,
+                   size * sizeof(ElementT));
+        bulk_to_host(store_to.data() + offset, size);
+      }
+
+      return input_stream;
+    }
+
     store_to.reserve(size);
 
     for (auto i = 0; i < size; ++i) {
@@ -81,8 +169,7 @@ struct ExtractArrayHelper<ExtractSizeAsT, llvm::ulittle8_t, StoreToT> {
     store_to.resize(size);
 
     if (size > 0) {
-      static_cast<std::istream &>(input_stream)
-          .read(reinterpret_cast<char *>(store_to.data()), size);
+      read_bytes(input_stream, store_to.data(), size);
     }
 
     return input_stream;
@@ -108,9 +195,7 @@ struct ExtractArrayHelper<
     store_to.resize(size);
 
     if (size > 0) {
-      static_cast<std::istream &>(input_stream)
-          .read(reinterpret_cast<char *>(store_to.data()),
-                size * sizeof(PESIT));
+      read_bytes(input_stream, store_to.data(), size * sizeof(PESIT));
     }
 
     return input_stream;
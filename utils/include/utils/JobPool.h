@@ -0,0 +1,72 @@
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// Fixed set of workers, each owning a job queue. Idle workers steal from the
+// back of other queues, so long jobs don't leave the rest of the pool idle.
+class JobPool : public NonCopyable {
+public:
+  // Job receives index of the worker running it: [0, thread_count())
+  using Job = std::function<void(std::size_t worker_index)>;
+
+  // Jobs submitted with a batch can be waited for apart from the rest of the
+  // pool, so callers sharing a pool don't wait for each other's jobs
+  class Batch : public NonCopyable {
+  public:
+    Batch() : m_pending_jobs{0} {}
+
+  private:
+    friend class JobPool;
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_finished;
+    std::size_t m_pending_jobs;
+  };
+
+  explicit JobPool(std::size_t thread_count);
+  ~JobPool();
+
+  auto thread_count() const -> std::size_t;
+
+  void submit(Job job);
+  void submit(Job job, Batch &batch);
+
+  // Blocks until all submitted jobs are finished
+  void wait();
+
+  // Blocks until jobs submitted with the batch are finished
+  void wait(Batch &batch);
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_mutex;
+  std::condition_variable m_job_added;
+  std::condition_variable m_job_finished;
+  std::size_t m_queued_jobs;
+  std::size_t m_pending_jobs;
+  std::size_t m_next_queue;
+  bool m_stopping;
+
+  void run(std::size_t worker_index);
+  auto take(std::size_t worker_index, Job &job) -> bool;
+};
+
+} // namespace utils
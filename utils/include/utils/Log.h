@@ -1,6 +1,8 @@
 #pragma once
 
+#include <mutex>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -27,12 +29,13 @@ public:
   inline static bool colored = true;
 
   Log(LogLevel log_level, const std::string &space = "");
+  ~Log();
 
   auto operator<<(endl_type endl) -> Log &;
 
   template <typename T> auto operator<<(const T &value) -> Log & {
     if (check_filter()) {
-      m_output << value;
+      m_buffer << value;
     }
 
     return *this;
@@ -59,9 +62,16 @@ private:
     BrightWhite = 97,
   };
 
+  // Lines are buffered and written at once, so logs from different threads
+  // don't interleave
+  inline static std::mutex output_mutex;
+
   const LogLevel m_log_level;
   const std::string m_space;
   std::ostream &m_output;
+  std::ostringstream m_buffer;
+
+  void flush();
 
   auto log_level_prefix() const -> std::string;
   auto check_filter() const -> bool;
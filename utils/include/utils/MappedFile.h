@@ -0,0 +1,31 @@
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <cstddef>
+#include <filesystem>
+
+namespace utils {
+
+// Read-only memory mapping of the whole file
+class MappedFile : public NonCopyable {
+public:
+  explicit MappedFile(const std::filesystem::path &path);
+  ~MappedFile();
+
+  auto valid() const -> bool;
+
+  auto data() const -> const unsigned char *;
+  auto size() const -> std::size_t;
+
+private:
+  const unsigned char *m_data;
+  std::size_t m_size;
+
+#if _WIN32
+  void *m_file;
+  void *m_mapping;
+#endif
+};
+
+} // namespace utils
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "ByteReader.h"
+
 #include <istream>
 
 namespace utils {
 
 void dump(std::istream &input, int line_count = 64, int line_length = 24);
+void dump(ByteReader &input, int line_count = 64, int line_length = 24);
 
 }
@@ -0,0 +1,121 @@
+#include <utils/Arena.h>
+#include <utils/Assert.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace utils {
+
+static thread_local Arena *current_arena = nullptr;
+
+Arena::Arena(std::size_t chunk_size)
+    : m_chunk_size{chunk_size}, m_chunk{0}, m_offset{0} {
+
+  ASSERT(chunk_size > 0, "Utils", "Arena chunk size must be positive");
+}
+
+Arena::~Arena() {
+  for (const auto &chunk : m_chunks) {
+    std::free(chunk.data);
+  }
+}
+
+void Arena::reset() {
+  std::lock_guard lock{m_mutex};
+
+  m_chunk = 0;
+  m_offset = 0;
+  m_free_blocks.clear();
+}
+
+auto Arena::capacity() const -> std::size_t {
+  std::lock_guard lock{m_mutex};
+
+  std::size_t capacity = 0;
+
+  for (const auto &chunk : m_chunks) {
+    capacity += chunk.size;
+  }
+
+  return capacity;
+}
+
+auto Arena::current() -> Arena * { return current_arena; }
+
+Arena::Scope::Scope(Arena &arena) : m_previous{current_arena} {
+  current_arena = &arena;
+}
+
+Arena::Scope::~Scope() { current_arena = m_previous; }
+
+auto Arena::do_allocate(std::size_t bytes, std::size_t alignment) -> void * {
+  std::lock_guard lock{m_mutex};
+
+  if (bytes >= LARGE_BLOCK_SIZE) {
+    const auto block = std::find_if(
+        m_free_blocks.begin(), m_free_blocks.end(),
+        [bytes, alignment](const Block &block) {
+          return block.size == bytes && block.alignment == alignment;
+        });
+
+    if (block != m_free_blocks.end()) {
+      auto *data = block->data;
+      *block = m_free_blocks.back();
+      m_free_blocks.pop_back();
+      return data;
+    }
+  }
+
+  while (true) {
+    if (m_chunk < m_chunks.size()) {
+      const auto &chunk = m_chunks[m_chunk];
+      const auto base = reinterpret_cast<std::uintptr_t>(chunk.data);
+      const auto address =
+          (base + m_offset + alignment - 1) & ~(std::uintptr_t{alignment} - 1);
+
+      if (address + bytes <= base + chunk.size) {
+        m_offset = address + bytes - base;
+        return reinterpret_cast<void *>(address);
+      }
+
+      // Rest of the chunk stays unused until reset
+      if (m_chunk + 1 < m_chunks.size()) {
+        m_chunk++;
+        m_offset = 0;
+        continue;
+      }
+    }
+
+    const auto size = std::max(m_chunk_size, bytes + alignment);
+    auto *data = static_cast<std::byte *>(std::malloc(size));
+
+    if (data == nullptr) {
+      throw std::bad_alloc{};
+    }
+
+    m_chunks.push_back({data, size});
+    m_chunk = m_chunks.size() - 1;
+    m_offset = 0;
+  }
+}
+
+void Arena::do_deallocate(void *pointer, std::size_t bytes,
+                          std::size_t alignment) {
+
+  if (bytes < LARGE_BLOCK_SIZE) {
+    return;
+  }
+
+  std::lock_guard lock{m_mutex};
+  m_free_blocks.push_back({pointer, bytes, alignment});
+}
+
+auto Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+    -> bool {
+
+  return this == &other;
+}
+
+} // namespace utils
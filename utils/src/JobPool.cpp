@@ -0,0 +1,141 @@
+#include <utils/Assert.h>
+#include <utils/JobPool.h>
+
+namespace utils {
+
+JobPool::JobPool(std::size_t thread_count)
+    : m_queued_jobs{0}, m_pending_jobs{0}, m_next_queue{0}, m_stopping{false} {
+
+  ASSERT(thread_count > 0, "Utils", "Job pool must have at least one thread");
+
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    m_threads.emplace_back([this, i] { run(i); });
+  }
+}
+
+JobPool::~JobPool() {
+  wait();
+
+  {
+    std::lock_guard lock{m_mutex};
+    m_stopping = true;
+  }
+
+  m_job_added.notify_all();
+
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+auto JobPool::thread_count() const -> std::size_t { return m_threads.size(); }
+
+void JobPool::submit(Job job) {
+  {
+    std::lock_guard lock{m_mutex};
+
+    auto &queue = *m_queues[m_next_queue];
+    m_next_queue = (m_next_queue + 1) % m_queues.size();
+
+    {
+      std::lock_guard queue_lock{queue.mutex};
+      queue.jobs.push_back(std::move(job));
+    }
+
+    m_queued_jobs++;
+    m_pending_jobs++;
+  }
+
+  m_job_added.notify_one();
+}
+
+void JobPool::submit(Job job, Batch &batch) {
+  {
+    std::lock_guard lock{batch.m_mutex};
+    batch.m_pending_jobs++;
+  }
+
+  submit([job = std::move(job), &batch](std::size_t worker_index) {
+    job(worker_index);
+
+    // Notified under the lock, the waiter may destroy the batch once it sees
+    // no pending jobs
+    std::lock_guard lock{batch.m_mutex};
+    batch.m_pending_jobs--;
+    batch.m_job_finished.notify_all();
+  });
+}
+
+void JobPool::wait() {
+  std::unique_lock lock{m_mutex};
+  m_job_finished.wait(lock, [this] { return m_pending_jobs == 0; });
+}
+
+void JobPool::wait(Batch &batch) {
+  std::unique_lock lock{batch.m_mutex};
+  batch.m_job_finished.wait(lock,
+                            [&batch] { return batch.m_pending_jobs == 0; });
+}
+
+void JobPool::run(std::size_t worker_index) {
+  while (true) {
+    Job job;
+
+    if (take(worker_index, job)) {
+      job(worker_index);
+
+      {
+        std::lock_guard lock{m_mutex};
+        m_pending_jobs--;
+      }
+
+      m_job_finished.notify_all();
+      continue;
+    }
+
+    std::unique_lock lock{m_mutex};
+    m_job_added.wait(lock,
+                     [this] { return m_stopping || m_queued_jobs > 0; });
+
+    if (m_stopping && m_queued_jobs == 0) {
+      return;
+    }
+  }
+}
+
+auto JobPool::take(std::size_t worker_index, Job &job) -> bool {
+  const auto queue_count = m_queues.size();
+
+  // Own queue first, then steal from the others
+  for (std::size_t i = 0; i < queue_count; ++i) {
+    auto &queue = *m_queues[(worker_index + i) % queue_count];
+
+    {
+      std::lock_guard queue_lock{queue.mutex};
+
+      if (queue.jobs.empty()) {
+        continue;
+      }
+
+      if (i == 0) {
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+      } else {
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+      }
+    }
+
+    std::lock_guard lock{m_mutex};
+    m_queued_jobs--;
+    return true;
+  }
+
+  return false;
+}
+
+} // namespace utils
@@ -9,21 +9,37 @@ Log::Log(LogLevel log_level, const std::string &space)
 
   if (check_filter()) {
     if (m_space.empty()) {
-      m_output << log_level_prefix() << ": ";
+      m_buffer << log_level_prefix() << ": ";
     } else {
-      m_output << log_level_prefix() << " (" << m_space << "): ";
+      m_buffer << log_level_prefix() << " (" << m_space << "): ";
     }
   }
 }
 
+Log::~Log() { flush(); }
+
 auto Log::operator<<(endl_type endl) -> Log & {
   if (check_filter()) {
-    m_output << ansi_color(Color::Clear) << endl;
+    m_buffer << ansi_color(Color::Clear) << endl;
+    flush();
   }
 
   return *this;
 }
 
+void Log::flush() {
+  if (m_buffer.tellp() <= 0) {
+    return;
+  }
+
+  {
+    std::lock_guard lock{output_mutex};
+    m_output << m_buffer.str() << std::flush;
+  }
+
+  m_buffer.str("");
+}
+
 auto Log::log_level_prefix() const -> std::string {
   switch (m_log_level) {
   case LOG_FATAL: {
@@ -0,0 +1,107 @@
+#include <utils/MappedFile.h>
+
+#if _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+#if _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : m_data{nullptr}, m_size{0}, m_file{INVALID_HANDLE_VALUE},
+      m_mapping{nullptr} {
+
+  m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (m_file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+
+  LARGE_INTEGER size{};
+
+  if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+    return;
+  }
+
+  m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (m_mapping == nullptr) {
+    return;
+  }
+
+  m_data = static_cast<const unsigned char *>(
+      MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+  if (m_data != nullptr) {
+    m_size = static_cast<std::size_t>(size.QuadPart);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+  }
+
+  if (m_mapping != nullptr) {
+    CloseHandle(m_mapping);
+  }
+
+  if (m_file != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_file);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : m_data{nullptr}, m_size{0} {
+
+  const auto file = open(path.c_str(), O_RDONLY);
+
+  if (file == -1) {
+    return;
+  }
+
+  struct stat status {};
+
+  if (fstat(file, &status) == 0 && status.st_size > 0) {
+    auto *data = mmap(nullptr, static_cast<std::size_t>(status.st_size),
+                      PROT_READ, MAP_PRIVATE, file, 0);
+
+    if (data != MAP_FAILED) {
+      m_data = static_cast<const unsigned char *>(data);
+      m_size = static_cast<std::size_t>(status.st_size);
+
+      // Packages are always read from start to end
+      madvise(data, m_size, MADV_SEQUENTIAL);
+    }
+  }
+
+  // Mapping stays valid after the descriptor is closed
+  close(file);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+    munmap(const_cast<unsigned char *>(m_data), m_size);
+  }
+}
+
+#endif
+
+auto MappedFile::valid() const -> bool { return m_data != nullptr; }
+
+auto MappedFile::data() const -> const unsigned char * { return m_data; }
+
+auto MappedFile::size() const -> std::size_t { return m_size; }
+
+} // namespace utils
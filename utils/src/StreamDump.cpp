@@ -6,15 +6,7 @@
 
 namespace utils {
 
-void dump(std::istream &input, int line_count, int line_length) {
-  const auto byte_count = line_count * line_length * 2;
-
-  const auto offset = input.tellg();
-  auto buffer = std::make_unique<char[]>(byte_count);
-
-  input.seekg(-byte_count / 2, std::ios::cur);
-  input.read(buffer.get(), byte_count);
-
+static void print(const char *buffer, int line_count, int line_length) {
   {
     printf("\n");
     printf("   ");
@@ -95,8 +87,34 @@ void dump(std::istream &input, int line_count, int line_length) {
 
     printf("\n");
   }
+}
+
+void dump(std::istream &input, int line_count, int line_length) {
+  const auto byte_count = line_count * line_length * 2;
+
+  const auto offset = input.tellg();
+  auto buffer = std::make_unique<char[]>(byte_count);
+
+  input.seekg(-byte_count / 2, std::ios::cur);
+  input.read(buffer.get(), byte_count);
+
+  print(buffer.get(), line_count, line_length);
 
   input.seekg(offset);
 }
 
+void dump(ByteReader &input, int line_count, int line_length) {
+  const auto byte_count = line_count * line_length * 2;
+
+  const auto offset = input.tell();
+  auto buffer = std::make_unique<char[]>(byte_count);
+
+  input.skip(-byte_count / 2);
+  input.read(buffer.get(), byte_count);
+
+  print(buffer.get(), line_count, line_length);
+
+  input.seek(offset);
+}
+
 } // namespace utils